@@ -0,0 +1,27 @@
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <string>
+
+#include "Parameters.h"
+#include "ThreadPool.h"
+
+// where worker threads are placed
+enum AffinityPolicy { AFFINITY_NONE, AFFINITY_COMPACT, AFFINITY_SCATTER, AFFINITY_LIST };
+
+// a logical CPU and where it sits in the machine
+struct CpuInfo
+{
+    int cpu;        // the logical CPU number
+    int package;    // the socket it is on
+    int core;       // the rank of its core within the socket
+    int sibling;    // its rank among the hardware threads of its core
+};
+
+int  readTopology(CpuInfo* cpus, const int maxCpus);
+int  parseCpuList(const std::string& list, int* cpus, const int maxCpus);
+int  placeThreads(Parameters params, const int numThreads, int* placement, const int offset = 0);
+void pinThreads(Parameters params, ThreadPool* pool, const int offset = 0);
+
+#endif
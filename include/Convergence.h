@@ -0,0 +1,39 @@
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+#include "RecordKeeper.h"
+#include "ThreadPool.h"
+
+// the per experiment history a convergence curve is read from
+typedef double (RecordKeeper::*Curve)(const int);
+
+// The convergence curves of a group of replicates. Every experiment keeps
+// the value of each replicate in sorted order, so two groups merge like the
+// halves of a merge sort and any quantile can be read off the result.
+class Convergence
+{
+private:
+    int     experimentations;   // how many experiments each replicate ran
+    int     count;              // how many replicates are in the group
+    double* values;             // experimentations x count, each row sorted
+
+public:
+    // constructors and destructors
+    Convergence(RecordKeeper* record, Curve curve);
+    Convergence(Convergence* first, Convergence* second);
+    ~Convergence();
+
+    // functions for the single variables
+    int    getExperimentations();
+    int    getCount();
+
+    // functions for the statistics of an experiment
+    double getMean(const int experiment);
+    double getQuantile(const int experiment, double q);
+};
+
+Convergence** reduceReplicates(RecordKeeper** records, const int replicates, Curve curve, ThreadPool* pool);
+void          destroyConvergence(Convergence** curves, const int numFuncs);
+
+#endif
@@ -0,0 +1,20 @@
+
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include "Parameters.h"
+#include "RecordKeeper.h"
+#include "ThreadPool.h"
+
+// A job is one run of one algorithm on one function of one replicate,
+// numbered algorithm by algorithm, then replicate by replicate, so the
+// records of job j of an algorithm are at index j of its RecordKeeper array.
+int  jobCount(Parameters params);
+void runJob(Parameters params, const int job, RecordKeeper* rk, ThreadPool* pool);
+
+// the coordinator splits the jobs into shards and hands them to worker
+// processes of the same executable over a Unix domain socket
+int  runCoordinator(Parameters params, RecordKeeper*** records);
+int  runWorker(const char* socketPath, const int index);
+
+#endif
@@ -0,0 +1,39 @@
+
+#ifndef GLOBAL_BEST_H
+#define GLOBAL_BEST_H
+
+#include <atomic>
+
+// The best solution found by a swarm, shared by every thread working on
+// it. Offers that cannot win are turned away by one atomic load of the
+// fitness. A winning offer claims the sequence number (making it odd),
+// copies itself in, and releases it (making it even again). Readers never
+// wait on a writer: they copy the solution and start over if the sequence
+// number changed while they did.
+class GlobalBest
+{
+private:
+    int size;                           // the size of the solution
+
+    std::atomic<unsigned> sequence;     // odd while a writer is copying
+    std::atomic<double>   fitness;      // the fitness of the solution
+    std::atomic<double>*  solution;     // the solution itself
+    int                   round;        // the round the solution was offered in
+    int                   index;        // the index of the solution within its round
+
+public:
+    // constructors and destructors
+    GlobalBest(const int solutionSize);
+    ~GlobalBest();
+
+    // functions for writers
+    bool   offer(const double* newSolution, double newFitness, const int newRound, const int newIndex);
+    void   reset();
+
+    // functions for readers
+    double getFitness();
+    double getElement(const int elem);
+    double read(double* out);
+};
+
+#endif
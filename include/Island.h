@@ -0,0 +1,115 @@
+
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include <atomic>
+#include <memory>
+
+#include "Optimizer.h"
+#include "Population.h"
+#include "RecordKeeper.h"
+
+// the ways the islands of a population can be linked
+enum Topology { TOPO_RING, TOPO_TORUS };
+
+// Bounded single producer, single consumer queue of migrants. Only the
+// sending island writes tail and only the receiving island writes head,
+// so neither side ever takes a lock. A migrant that finds the queue full
+// is dropped.
+class MigrationQueue
+{
+private:
+    unsigned capacity;              // how many migrants fit (a power of 2)
+    int      solutionSize;          // the size of each migrant
+    double*  slots;                 // capacity x (solutionSize + 1), the fitness last
+
+    std::atomic<unsigned> head;     // the next migrant to read
+    std::atomic<unsigned> tail;     // the next slot to write
+
+public:
+    // constructors and destructors
+    MigrationQueue(const int minCapacity, const int size);
+    ~MigrationQueue();
+
+    // functions for the migrants
+    bool push(double* solution, double fitness);
+    bool pop(double* solution, double& fitness);
+};
+
+class Island;
+
+// how an algorithm takes a migrant into its population
+typedef void (*Acceptor)(Population* pop, double* solution, double fitness);
+
+// One sub-population of a split population, and the queues linking it to
+// its neighbours. Every interval generations it sends copies of its best
+// solutions downstream and takes in whatever has arrived from upstream.
+class Island
+{
+private:
+    int interval;                   // generations between migrations
+    int migrants;                   // how many elites are sent per migration
+    int numOut;                     // how many neighbours are sent to
+    int numIn;                      // how many neighbours are received from
+
+    MigrationQueue* outbound[2];    // the queues to the downstream neighbours
+    MigrationQueue* inbound[2];     // the queues from the upstream neighbours
+    Acceptor        accept;         // takes a migrant into the population
+
+public:
+    // constructors
+    Island();
+
+    // functions for the links
+    void setup(const int newInterval, const int newMigrants, Acceptor newAccept);
+    void addOutbound(MigrationQueue* queue);
+    void addInbound(MigrationQueue* queue);
+
+    // functions for migration
+    void migrate(Population* pop, const int generation);
+};
+
+// A population split into islands, run as a single optimizer. By default
+// every island is its own resumable run on the pool that migrates after
+// its own generations, so no island ever waits for another; the migrants
+// then depend on which island got there first. In lockstep every island
+// runs a generation as a task on the pool, and once all are done the
+// islands migrate one after another in order, so a seed always gives the
+// same migrants.
+class IslandOptimizer : public Optimizer
+{
+private:
+    int              count;         // how many islands there are
+    bool             lockstep;      // whether the islands wait for each other
+    Population**     pops;          // the population of each island
+    RecordKeeper**   rks;           // the records of each island
+    Optimizer**      runs;          // the optimizer of each island
+    Island*          islands;       // the links of each island
+    MigrationQueue** queues;        // every queue between the islands
+    int              numQueues;     // how many queues there are
+
+    void forEachIsland(std::function<void(int)> body);
+    void scheduleIsland(const int k, ThreadPool* pool, TaskGroup* group, double cost,
+                        std::shared_ptr<std::atomic<int>> running, std::function<void()> done);
+
+protected:
+    void initialize();
+    void generate(const int gen);
+
+    double getBestFit();
+    double getDiversity();
+
+public:
+    // constructors and destructors
+    IslandOptimizer(Population* newPop, RecordKeeper* newRk, OptimizerMaker make, Acceptor accept);
+    ~IslandOptimizer();
+
+    void finish();
+    void schedule(ThreadPool* pool, TaskGroup* group, double cost, std::function<void()> done);
+};
+
+Optimizer* makeOptimizer(Population* pop, RecordKeeper* rk, OptimizerMaker make, Acceptor accept);
+void runIslands(Population* pop, RecordKeeper* rk, OptimizerMaker make, Acceptor accept);
+void mergeIslandRecords(RecordKeeper* rk, RecordKeeper** records, Population** pops, const int count);
+
+#endif
@@ -0,0 +1,33 @@
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+// A k-d tree over a set of points, for finding the nearest neighbours of
+// each. Every node splits its points at the median of the dimension they
+// are most spread out in, so the tree is balanced and a node's children
+// follow from its index. The tree only keeps pointers to the points, so
+// they must not change while it is in use.
+class KdTree
+{
+private:
+    int             dims;       // the size of each point
+    int             count;      // how many points there are
+    double* const*  points;     // the points (not owned)
+    int*            order;      // the point ids, each node's points contiguous
+    int*            splitDim;   // the dimension each node splits on
+    double*         splitValue; // the value each node splits at
+
+    void build(const int node, const int from, const int to);
+    void search(const int node, const int from, const int to, const double* query,
+                const int exclude, const int k, double* bestDist, int* bestId, int& found);
+
+public:
+    // constructors and destructors
+    KdTree(double* const* newPoints, const int numPoints, const int numDims);
+    ~KdTree();
+
+    // functions for the neighbours
+    int nearest(const double* query, const int exclude, const int k, int* neighbours);
+};
+
+#endif
@@ -0,0 +1,36 @@
+
+#ifndef NEIGHBOURHOOD_H
+#define NEIGHBOURHOOD_H
+
+#include "Random.h"
+
+// the neighbourhoods the particles of a swarm can follow
+enum SwarmTopology { SWARM_GLOBAL, SWARM_RING, SWARM_VON_NEUMANN, SWARM_RANDOM };
+
+// Who each particle of a swarm listens to, and the best personal best
+// among them. The links are kept both ways, so when a particle's personal
+// best improves only the particles it informs are checked; a personal
+// best only ever gets better, so it either takes over their local best
+// or changes nothing, and the swarm never has to be rescanned.
+class Neighbourhood
+{
+private:
+    int  size;          // how many particles there are
+    int* listenStart;   // where each particle's informants start in listens
+    int* listens;       // the informants of every particle (each includes itself)
+    int* informStart;   // where each particle's listeners start in informs
+    int* informs;       // the listeners of every particle
+    int* best;          // the informant with the best personal best, per particle
+
+public:
+    // constructors and destructors
+    Neighbourhood(const int topology, const int swarmSize, const int informants, Random* rng);
+    ~Neighbourhood();
+
+    // functions for the local bests
+    void reset(const double* pBestFit);
+    void improve(const int particle, const double* pBestFit);
+    int  getBest(const int particle);
+};
+
+#endif
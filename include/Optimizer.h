@@ -0,0 +1,63 @@
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <functional>
+
+#include "Population.h"
+#include "RecordKeeper.h"
+#include "ThreadPool.h"
+
+// One optimization run as an explicit state machine. Everything the run
+// needs between generations is kept in the object instead of on a stack,
+// so the run can stop after any generation and carry on later, from any
+// thread. A few threads can then take turns at thousands of small runs.
+class Optimizer
+{
+protected:
+    Population*   pop;          // the population being optimized
+    RecordKeeper* rk;           // records the optimization process
+    int           generation;   // how many generations have run
+    bool          started;      // whether the starting population exists
+    bool          stopped;      // whether the run stopped before its last generation
+    double        bestSoFar;    // the best fitness of any generation so far
+    int           stale;        // generations in a row that did not improve on it
+
+    // the steps of each algorithm
+    virtual void initialize() = 0;
+    virtual void generate(const int gen) = 0;
+
+    // the best fitness and the diversity of the last generation
+    virtual double getBestFit();
+    virtual double getDiversity();
+
+    bool converged();
+
+public:
+    // constructors and destructors
+    Optimizer(Population* newPop, RecordKeeper* newRk);
+    virtual ~Optimizer();
+
+    // functions for the steps of the run
+    void         start();
+    void         step();
+    virtual void finish();
+    bool         resume();
+    virtual void schedule(ThreadPool* pool, TaskGroup* group, double cost,
+                          std::function<void()> done);
+
+    // getters
+    Population*   getPopulation();
+    RecordKeeper* getRecords();
+    int           getGeneration();
+    bool          isDone();
+};
+
+// builds the optimizer of an algorithm for one population
+typedef Optimizer* (*OptimizerMaker)(Population* pop, RecordKeeper* record);
+
+void runOptimizer(Optimizer* opt);
+void scheduleOptimizer(Optimizer* opt, ThreadPool* pool, TaskGroup* group, double cost,
+                       std::function<void()> done);
+
+#endif
@@ -2,9 +2,25 @@
 #ifndef PARAMETERS_H
 #define PARAMETERS_H
 
+#include <cstdint>
+#include <string>
+
 struct Parameters
 {
     // general variables
+    uint64_t seed;
+    int initMethod;
+    int numThreads;
+    int chunkSize;
+    int replicates;
+    int islands;
+    int migrationInterval;
+    int migrants;
+    int topology;
+    int lockstep;
+    int processes;
+    int affinity;
+    std::string cpuList;
     int popSize;
     int experimentations;
     int numDims;
@@ -12,21 +28,39 @@ struct Parameters
 
     float* lowRanges;
     float* highRanges;
+    double* targets;
+
+    // stopping variables
+    int    patience;
+    double minDiversity;
 
     // PSO variables
     double dampener;
     double velConst1;
     double velConst2;
+    int    psoMode;
+    int    psoSweeps;
+    int    psoBudget;
+    int    psoTopology;
+    int    psoInformants;
 
     // HS variables
     double bandwidth;
     double hmcr;
     double par;
+    int    hsBatch;
 
     // FFO variables
     double alpha;
     double beta;
     double gamma;
+    int    ffaNearest;
+
+    // DE variables
+    double deScale;
+    double deCrossover;
+    int    deStrategy;
+    double dePBest;
 
     // auxillary functions
     void setupRanges(const int funcs);
@@ -2,8 +2,23 @@
 #ifndef POPULATION_H
 #define POPULATION_H
 
+#include <functional>
 #include <random>
+
+#include "GlobalBest.h"
+#include "Neighbourhood.h"
 #include "Parameters.h"
+#include "ThreadPool.h"
+
+// summary of the fitness array, gathered in a single pass
+struct PopulationStats
+{
+    int    bestIndex;       // index of the lowest fitness
+    int    worstIndex;      // index of the highest fitness
+    double mean;            // the average fitness
+    double variance;        // the variance of the fitness
+    double diversity;       // the rms distance to the centroid, over the range width
+};
 
 class Population {
 
@@ -14,6 +29,14 @@ private:
     int funcCalls;          // how many times a fitness function has been called
     int function;           // which function the population is running
     int numFuncs;           // how total functions there are
+    uint64_t seed;          // the master seed of the run
+    int initMethod;         // how the starting population is sampled
+    int chunkSize;          // how many solutions one task of a sweep handles
+    int island;             // which island the population is (0 without islands)
+
+    Parameters parameters;  // what the population was built from, for its islands
+
+    ThreadPool* pool;       // the pool sweeps are split across (may be nullptr)
 
     double lowerBound;      // the lowest acceptable value of an element in a solution
     double upperBound;      // the highest acceptable value of an element in a solution
@@ -29,12 +52,32 @@ private:
     double bandwidth;       // constants for HS
     double hmcr;
     double par;
+    int    batchSize;      // how many harmonies are improvised at once
+    int    updateMode;     // whether PSO moves the swarm in lockstep or asynchronously
+    int    sweeps;         // how many times PSO moves the swarm per generation (0 for popSize)
+    int    evalBudget;     // the most evaluations a PSO run may use (0 for no limit)
+    int    swarmTopology;  // which neighbourhood each particle follows
+    int    informants;     // how many others each particle informs (random topology)
+    int    nearest;        // how many nearest fireflies each firefly looks at (0 for all)
+
+    double scale;          // constants for DE
+    double crossover;
+    int    strategy;       // how DE builds its mutants
+    double pBestRate;      // the share of the best DE picks a pbest from
+
+    double target;         // the fitness a run stops at (-inf for none)
+    int    patience;       // generations without improvement a run stops after (0 for never)
+    double minDiversity;   // the diversity a run stops below (0 for never)
+    double diversity;      // the diversity of the last statistics gathered
 
     double*  fitness;       // the normalized cost of a function
     double** population;    // the genes of the population (an array of gene pointers)
+    int*     slot;          // which buffer each solution lives in, follows the row when it moves
+    int*     slotOwner;     // which solution lives in each buffer
+    int*     slotVersion;   // how many times each buffer has been given a new solution
 
-    double   globBestFit;   // The global best fitness of the population
-    double*  globBestVec;   // The global best vector
+    GlobalBest* globBest;   // The global best vector and fitness, shared by every thread
+    Neighbourhood* neighbourhood; // the local best of each particle (nullptr for the global best)
     double*  pBestFit;      // The array of each personal best fitness
     double** pBestVec;      // the personal best fitness solution of each solution
     double** velocity;      // The matrix of velocities
@@ -50,6 +93,18 @@ public:
     // functions for single variables
     int     getExperimentations();
     int     getNumFuncs();
+    uint64_t getSeed();
+    int     getInitMethod();
+    int     getChunkSize();
+    int     getIsland();
+    void    setIsland(const int newIsland);
+    Parameters getParameters();
+
+    // functions for the thread pool
+    void    setThreadPool(ThreadPool* newPool);
+    ThreadPool* getThreadPool();
+    void    forEachChunk(std::function<void(int, int)> body);
+    void    forEachChunk(const int count, std::function<void(int, int)> body);
     int     getPopSize();
     int     getSolutionSize();
     double  getLowerBound();
@@ -58,19 +113,37 @@ public:
     double  getDampener();
     double  getVelConst1();
     double  getVelConst2();
+    int     getUpdateMode();
+    int     getSweeps();
+    int     getEvalBudget();
+    int     getSwarmTopology();
+    int     getInformants();
 
     double  getAlpha();
     double  getBeta();
     double  getGamma();
+    int     getNearest();
 
     double  getBandwidth();
     double  getHMCR();
     double  getPAR();
+    int     getBatchSize();
+
+    double  getScale();
+    double  getCrossover();
+    int     getStrategy();
+    double  getPBestRate();
+
+    double  getTarget();
+    int     getPatience();
+    double  getMinDiversity();
+    double  getDiversity();
 
     // functions for funcCalls
     int     getFuncCalls();
     void    resetFuncCalls();
     void    incrimentFuncCalls();
+    void    addFuncCalls(const int calls);
 
     // functions for function
     int     getFunction();
@@ -80,16 +153,23 @@ public:
     void    setPBestVec(const int vec, const int elem, double newVal);
     void    setPBestFit(const int vec, double newFit);
     double  getPBestVec(const int vec, const int elem);
+    double* getPBestVec(const int vec);
     double  getPBestFit(const int vec);
+    double* getPBestFit();
 
-    // functions for globBestVec and globBestFit
-    void    setGlobalBestVec(const int elem, double newBest);
-    void    setGlobalBestFit(double newBest);
+    // functions for the global best
+    bool    offerGlobalBest(const double* newSolution, double newFitness, const int round, const int index);
+    double  readGlobalBest(double* out);
     double  getGlobalBestVec(const int elem);
     double  getGlobalBestFit();
 
+    // functions for the neighbourhoods
+    void           setNeighbourhood(Neighbourhood* newNeighbourhood);
+    Neighbourhood* getNeighbourhood();
+
     // functions for fitness
     int     getIndexOfBest();
+    PopulationStats getStats();
     void    generateAllFitness();
     void    generateOneFitness(const int solutionIndex);
     void    setFitness(const int index, double newFitness);
@@ -101,10 +181,17 @@ public:
     void    setPopulation(const int vec, const int elem, double newValue);
     double  getPopulation(const int vec, const int element);
     double* getPopulation(const int vec);
+    int     getSlot(const int vec);
+    int     getSlotOwner(const int buffer);
+    int     getSlotVersion(const int buffer);
+    void    insertSolution(const int vec, double* newSolution, double newFitness);
+    int     insertSorted(double* newSolution, double newFitness);
+    int     replaceWorst(double* newSolution, double newFitness);
 
     // functions for velocity
     void    setVelocity(const int vec, const int elem, double newValue);
     double  getVelocity(const int vec, const int elem);
+    double* getVelocity(const int vec);
 
     // misc functions
     void    sortPopulation();
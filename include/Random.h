@@ -0,0 +1,96 @@
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// the optimizers, used to give each one its own random streams
+enum Algorithm { ALG_PSO, ALG_FFA, ALG_HS, ALG_DE };
+
+// the island has the top 8 bits of a counter word, so no more islands get their own streams
+const int MAX_ISLANDS = 256;
+
+// Philox4x32-10 counter based generator. The key is the master seed and the
+// counter addresses every draw by {draw, member, step, island/algorithm/function},
+// so a stream only depends on what it is used for and never on which thread
+// or in which order it is used. It can be handed to the <random>
+// distributions directly.
+class Random
+{
+private:
+    uint32_t key[2];        // the master seed
+    uint32_t counter[4];    // the address of the next block of the stream
+    uint32_t block[4];      // the most recent block of output
+    int      used;          // how many words of block have been handed out
+
+    static void philox(const uint32_t* ctr, const uint32_t* k, uint32_t* out)
+    {
+        uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+        uint32_t k0 = k[0],   k1 = k[1];
+
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+
+            c0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+            c1 = uint32_t(p1);
+            c2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c3 = uint32_t(p0);
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    // constructors
+    Random(uint64_t seed, const int algorithm, const int function, const int island);
+
+    // functions for the stream
+    void setStream(const int step, const int member);
+
+    // functions for std::uniform_random_bit_generator
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()()
+    {
+        if (used == 4)
+        {
+            philox(counter, key, block);
+            ++counter[0];
+            used = 0;
+        }
+
+        uint64_t result = (uint64_t(block[used]) << 32) | block[used + 1];
+        used += 2;
+
+        return result;
+    }
+
+    // a uniform double in [0, 1)
+    double uniform()
+    {
+        return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // a uniform double in [low, high)
+    double uniform(double low, double high)
+    {
+        return low + (high - low) * uniform();
+    }
+
+    // functions for drawing blocks of numbers
+    void fillUniform(double* buffer, const int n);
+    void fillNormal(double* buffer, const int n);
+};
+
+uint64_t generateMasterSeed();
+uint64_t replicateSeed(uint64_t seed, const int replicate);
+
+#endif
@@ -19,6 +19,8 @@ private:
 
     double* historicBestFit;
     double* historicWorstFit;
+    double* historicMeanFit;
+    double* historicVarFit;
 
     double** historicFit;   // stores the history of solution costs
     double** finalFit;      // the final costs of the solutions
@@ -45,6 +47,7 @@ public:
 
     // functions for historicPBest
     void   setHistoricPBest(double newPBest, const int popSize, const int experiment);
+    void   setHistoricPBest(double* newPBest, const int experiment);
     double getHistoricPBest(const int particle, const int experiment);
 
     // functions for historicBestFit and historicWorstFit
@@ -53,6 +56,12 @@ public:
     double getHistoricBestFit(const int element);
     double getHistoricWorstFit(const int element);
 
+    // functions for historicMeanFit and historicVarFit
+    void   setHistoricMeanFit(double newMean, const int element);
+    void   setHistoricVarFit(double newVar, const int element);
+    double getHistoricMeanFit(const int element);
+    double getHistoricVarFit(const int element);
+
     // functions for historicFit
     void   setHistoricFit(double historicCost, const int population, const int experiment);
     void   setHistoricFit(double* historicCost, const int population);
@@ -70,6 +79,14 @@ public:
     void   setTimeTaken(double time, const int experiment);
     double getTimeTaken(const int experiment);
 
+    // functions for runs that stop early
+    void   holdRecords(const int from);
+
+    // functions for moving the records between processes
+    int    getPackedSize();
+    void   pack(double* buffer);
+    void   unpack(const double* buffer);
+
 };
 
 #endif
@@ -0,0 +1,83 @@
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// counts the unfinished tasks of one batch so the batch can be waited on
+struct TaskGroup
+{
+    std::atomic<int> remaining;
+
+    TaskGroup() : remaining(0) {}
+};
+
+// a unit of work and the group it belongs to
+struct Task
+{
+    std::function<void()> work;
+    TaskGroup* group;
+    double     cost;        // estimated cost, larger costs are started first
+
+    bool operator<(const Task& other) const { return cost < other.cost; }
+};
+
+// Persistent pool of worker threads. Tasks submitted from outside the pool
+// go to a shared queue ordered by cost, tasks submitted by a worker go to
+// the back of its own deque. A worker runs its own newest task first, then
+// the most expensive shared task, then steals the oldest task of another
+// worker. Waiting on a group runs tasks instead of blocking, so tasks can
+// submit and wait on tasks of their own.
+class ThreadPool
+{
+private:
+    struct Worker
+    {
+        std::mutex       lock;
+        std::deque<Task> tasks;
+    };
+
+    int          numThreads;    // how many worker threads there are
+    std::thread* threads;       // the worker threads
+    Worker*      workers;       // the deque of each worker
+
+    std::mutex                 sharedLock;
+    std::priority_queue<Task>  shared;      // tasks submitted from outside the pool
+
+    std::mutex              sleepLock;      // lets idle workers sleep
+    std::condition_variable wake;
+    std::atomic<int>        pending;        // tasks queued but not started
+    std::atomic<int>        spawned;        // the queued tasks that are in a worker's deque
+    std::atomic<bool>       stopping;
+
+    void enqueue(TaskGroup* group, std::function<void()> work, double cost, const int self);
+    bool takeTask(const int self, Task& task, const bool allowShared);
+    void runTask(Task& task);
+    void workerLoop(const int index);
+
+public:
+    // constructors and destructors
+    ThreadPool(const int threads);
+    ~ThreadPool();
+
+    // functions for the pool
+    int  getNumThreads();
+    int  getWorkerIndex();
+    std::thread::native_handle_type getNativeHandle(const int worker);
+
+    // functions for tasks
+    void submit(TaskGroup* group, std::function<void()> work, double cost);
+    void post(TaskGroup* group, std::function<void()> work, double cost);
+    void wait(TaskGroup* group);
+    void parallelFor(const int begin, const int end, const int chunk,
+                     std::function<void(int, int)> body);
+};
+
+#endif
@@ -2,13 +2,27 @@
 #ifndef CSV_H
 #define CSV_H
 
+#include <cstdint>
+#include <string>
+
+#include "Convergence.h"
+
 #include "Population.h"
 #include "RecordKeeper.h"
 
+// CSV for the run itself
+void seedCSV(uint64_t seed);
+
+// CSVs for the replicates of any algorithm
+void replicateCSVs(Convergence** curves, const int numFuncs, std::string prefix);
+void convergenceCSV(Convergence** curves, const int numFuncs, std::string pathName, double q);
+
 // CSVs for Particle Swarm
 void particleCSVs(RecordKeeper** records);
 void particleGBestFit(RecordKeeper** records);
 void particleWorstFit(RecordKeeper** records);
+void particleMeanFit(RecordKeeper** records);
+void particleVarFit(RecordKeeper** records);
 void particleFinalFits(RecordKeeper** records);
 void particleFuncCalls(RecordKeeper** records);
 void particleTimeTaken(RecordKeeper** records);
@@ -29,4 +43,14 @@ void harmonyFinalFits(RecordKeeper** records);
 void harmonyFuncCalls(RecordKeeper** records);
 void harmonyTimeTaken(RecordKeeper** records);
 
+// CSVs for Differential Evolution
+void differentialCSVs(RecordKeeper** records);
+void differentialHistBestFit(RecordKeeper** records);
+void differentialHistWorstFit(RecordKeeper** records);
+void differentialMeanFit(RecordKeeper** records);
+void differentialVarFit(RecordKeeper** records);
+void differentialFinalFits(RecordKeeper** records);
+void differentialFuncCalls(RecordKeeper** records);
+void differentialTimeTaken(RecordKeeper** records);
+
 #endif
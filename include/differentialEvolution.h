@@ -0,0 +1,50 @@
+
+#ifndef DIFFERENTIAL_EVOLUTION_H
+#define DIFFERENTIAL_EVOLUTION_H
+
+#include <ctime>
+
+#include "Island.h"
+#include "Optimizer.h"
+#include "Population.h"
+#include "Random.h"
+#include "RecordKeeper.h"
+#include "ThreadPool.h"
+
+// how DE builds the mutant of each solution
+enum DEStrategy { DE_RAND_1_BIN, DE_CURRENT_TO_PBEST };
+
+// Differential Evolution as an optimizer that runs a generation at a time
+class DEOptimizer : public Optimizer
+{
+private:
+    Random  rng;        // the generator of the run
+    double* trials;     // the trial solution of each solution
+    double* trialFits;  // the fitness of each trial
+    int*    ranks;      // the solutions from best to worst (current-to-pbest)
+    double* archive;    // parents that lost to their trials (current-to-pbest)
+    int     archived;   // how many parents the archive holds
+
+    void rankPopulation();
+    void buildTrial(Random* local, const int i, double* mask);
+    void select(const int gen);
+
+protected:
+    void initialize();
+    void generate(const int gen);
+
+public:
+    DEOptimizer(Population* newPop, RecordKeeper* newRk);
+    ~DEOptimizer();
+};
+
+void differentialEvolution(Population** pops, RecordKeeper** records, const int replicates, ThreadPool* pool, TaskGroup* group);
+void differentialResults(RecordKeeper** records, const int replicates, ThreadPool* pool);
+Optimizer* makeDifferentialEvolution(Population* pop, RecordKeeper* record);
+void acceptDifferential(Population* pop, double* migrant, double fitness);
+
+void initializeDE(Population* pop, Random* rng);
+int  pickOther(Random* rng, const int range, const int* taken, const int count);
+void updateRecordsDE(Population* pop, RecordKeeper* rk, const PopulationStats& stats, const std::clock_t timer, const int iteration);
+
+#endif
@@ -2,21 +2,60 @@
 #ifndef FIREFLY_H
 #define FIREFLY_H
 
+#include "Island.h"
+#include "Optimizer.h"
 #include "Population.h"
+#include "Random.h"
 #include "RecordKeeper.h"
+#include "ThreadPool.h"
 
-void firefly(Population** populations, RecordKeeper** records);
-void runFirefly(Population* population, RecordKeeper* record);
+// the Firefly algorithm as an optimizer that runs a generation at a time
+class FireflyOptimizer : public Optimizer
+{
+private:
+    Random  rng;        // the generator of the run
+    double* newPos;     // the position of a moving firefly
+    double* dist;       // the squared distances between slots
+    double* norms;      // the squared norm of each slot
+    int*    versions;   // the version of each slot its distances were computed at
+    int     nearest;    // how many neighbours each firefly looks at (0 for all)
+    int*    neighbours; // the slots of the neighbours of each slot
 
-void initializeFFO(Population* pop);
+    void refreshDistances(const int ff);
+    void sweepAll();
+    void sweepNearest();
+
+protected:
+    void initialize();
+    void generate(const int t);
+
+public:
+    FireflyOptimizer(Population* newPop, RecordKeeper* newRk);
+    ~FireflyOptimizer();
+};
+
+void firefly(Population** populations, RecordKeeper** records, const int replicates, ThreadPool* pool, TaskGroup* group);
+void fireflyResults(RecordKeeper** records, const int replicates, ThreadPool* pool);
+Optimizer* makeFirefly(Population* population, RecordKeeper* record);
+void acceptFirefly(Population* population, double* migrant, double fitness);
+
+void initializeFFO(Population* pop, Random* rng);
 
 // equations 1-4 (in order)
 double intensity(Population* population, const int ff, double r);
+double attenuation(Population* population, double r);
 double newBeta(Population* population, double r);
 double ffDistance(Population* population, const int ff1, const int ff2);
-void newPosition(Population* population, double* newPos, const int r, const int ff1, const int ff2);
-void addNewFirefly(Population* popualtion, double* newPos);
+void newPosition(Population* population, Random* rng, double* newPos, const int r, const int ff1, const int ff2);
+int  addNewFirefly(Population* popualtion, double* newPos);
+
+// the distances of the whole population, by slot
+void ffDistanceMatrix(Population* population, double* dist, double* norms);
+void ffDistanceRow(Population* population, double* dist, double* norms, const int ff);
+
+// the nearest neighbours of the whole population, by slot
+void ffNearest(Population* population, const int k, int* neighbours);
 
-void recordInfo(Population* pop, RecordKeeper* record, clock_t timer, const int iteration);
+void recordInfo(Population* pop, RecordKeeper* record, const PopulationStats& stats, clock_t timer, const int iteration);
 
 #endif
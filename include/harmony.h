@@ -2,18 +2,43 @@
 #ifndef HARMONY_H
 #define HARMONY_H
 
+#include "Island.h"
+#include "Optimizer.h"
 #include "Population.h"
+#include "Random.h"
 #include "RecordKeeper.h"
-
-void harmony(Population** pops, RecordKeeper** records);
-void runHarmony(Population* pop, RecordKeeper* record);
-
-void   initializeHS(Population* pop);
+#include "ThreadPool.h"
+
+// Harmony Search as an optimizer that runs an iteration at a time
+class HarmonyOptimizer : public Optimizer
+{
+private:
+    Random  rng;        // the generator of the run
+    int     batch;      // how many harmonies are improvised per iteration
+    double* newHarms;   // the harmonies of the batch
+    double* newFits;    // the fitness of each harmony of the batch
+
+protected:
+    void initialize();
+    void generate(const int i);
+
+public:
+    HarmonyOptimizer(Population* newPop, RecordKeeper* newRk);
+    ~HarmonyOptimizer();
+};
+
+void harmony(Population** pops, RecordKeeper** records, const int replicates, ThreadPool* pool, TaskGroup* group);
+void harmonyResults(RecordKeeper** records, const int replicates, ThreadPool* pool);
+Optimizer* makeHarmony(Population* pop, RecordKeeper* record);
+void acceptHarmony(Population* pop, double* migrant, double fitness);
+
+void   initializeHS(Population* pop, Random* rng);
+void   improvise(Population* pop, Random* rng, double* newHarm);
 void   pitchAdjust(Population* pop, double* newHarm, const int elem);
-double adjustPitch(double pitch, double bandwidth);
+double adjustPitch(double pitch, double bandwidth, Random* rng);
 void   addNewHarmony(Population* pop, double* newHarmony, double newFitness);
 
-void updateRecordsFF(Population* pop, RecordKeeper* rk, clock_t timer, const int iteration);
+void updateRecordsFF(Population* pop, RecordKeeper* rk, const PopulationStats& stats, clock_t timer, const int iteration);
 
 #endif
 
@@ -4,20 +4,42 @@
 
 #include <ctime>
 
+#include "Island.h"
+#include "Optimizer.h"
 #include "Population.h"
+#include "Random.h"
 #include "RecordKeeper.h"
+#include "ThreadPool.h"
 
-void particleSwarm(Population** populations, RecordKeeper** records);
-void runParticleSwarm(Population* pop, RecordKeeper* record);
+// how PSO moves the swarm: every particle in lockstep, or each on its own
+enum PSOMode { PSO_SYNC, PSO_ASYNC };
 
-void initializePSO(Population* pop);
-void updateRecords(Population* population, RecordKeeper* records, const std::clock_t, const int experiment);
+// Particle Swarm as an optimizer that runs a generation at a time
+class ParticleSwarmOptimizer : public Optimizer
+{
+private:
+    Random    rng;          // the generator of the run
+    long long evaluations;  // how many evaluations the generations have used
 
-void updateVelocity(Population* population);
-void updateParticles(Population* population);
-void updateFitness(Population* population);
-void updatePersonalBest(Population* population);
-void updateGlobalBest(Population* population);
+protected:
+    void initialize();
+    void generate(const int gen);
+
+public:
+    ParticleSwarmOptimizer(Population* newPop, RecordKeeper* newRk);
+};
+
+void particleSwarm(Population** populations, RecordKeeper** records, const int replicates, ThreadPool* pool, TaskGroup* group);
+void particleResults(RecordKeeper** records, const int replicates, ThreadPool* pool);
+Optimizer* makeParticleSwarm(Population* pop, RecordKeeper* record);
+void acceptParticle(Population* pop, double* migrant, double fitness);
+
+void initializePSO(Population* pop, Random* rng);
+void updateRecords(Population* population, RecordKeeper* records, const PopulationStats& stats, const std::clock_t, const int experiment);
+
+void updateSwarm(Population* population, Random* rng, const int step);
+void updateNeighbourhood(Population* population, const int step);
+void updateAsync(Population* population, Random* rng, const int first, const int sweeps);
 
 
 #endif
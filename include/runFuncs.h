@@ -3,5 +3,6 @@
 #define RUN_FUNCS_H
 
 double runSolution(double* solutionVector, const int size, const int func);
+double functionCost(const int func, const int size);
 
 #endif
@@ -0,0 +1,25 @@
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <cstdint>
+
+#include "Population.h"
+#include "Random.h"
+
+// the ways a population can be spread over the search space
+enum InitMethod { INIT_UNIFORM, INIT_LATIN, INIT_HALTON, INIT_SOBOL };
+
+void initializePopulation(Population* pop, Random* rng);
+
+void uniformSample(Population* pop, Random* rng);
+void latinHypercube(Population* pop, Random* rng);
+void haltonSequence(Population* pop, Random* rng);
+void sobolSequence(Population* pop, Random* rng);
+
+// helpers for the low discrepancy sequences
+int  nthPrime(const int n);
+bool isPrimitive(const int degree, const uint32_t poly);
+void sobolDirections(const int dim, uint32_t* directions);
+
+#endif
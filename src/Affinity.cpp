@@ -0,0 +1,234 @@
+/**
+ * @file Affinity.cpp
+ * @author Matthew Harker
+ * @brief Pins the worker threads to CPUs, using the machine's
+ *          topology as reported by sysfs
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "Affinity.h"
+
+using namespace std;
+
+/**
+ * @brief Reads a single number from a sysfs file
+ *
+ * @param path  The file
+ * @return int  The number, or -1 if the file could not be read
+ */
+static int readSysfsInt(const string& path)
+{
+    ifstream file(path);
+    int      value = -1;
+
+    if (file.is_open())
+        file >> value;
+
+    return value;
+}
+
+/**
+ * @brief Reads the topology of every CPU this process may run on.
+ *          The socket and core ids come from sysfs and are turned into
+ *          ranks, so a CPU's core rank counts the cores before it on
+ *          its socket and its sibling rank counts the hardware threads
+ *          before it on its core.
+ *
+ * @param cpus      The array to fill
+ * @param maxCpus   The size of the array
+ * @return int      How many CPUs were found
+ */
+int readTopology(CpuInfo* cpus, const int maxCpus)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    int* coreIds = new int[maxCpus];
+    int  count   = 0;
+
+    for (int c = 0; c < CPU_SETSIZE && count < maxCpus; ++c)
+    {
+        if (!CPU_ISSET(c, &allowed))
+            continue;
+
+        string base = "/sys/devices/system/cpu/cpu" + to_string(c) + "/topology/";
+
+        int package = readSysfsInt(base + "physical_package_id");
+        int core    = readSysfsInt(base + "core_id");
+
+        // without sysfs, every CPU is its own core on one socket
+        cpus[count].cpu     = c;
+        cpus[count].package = (package < 0) ? 0 : package;
+        coreIds[count]      = (core < 0) ? c : core;
+        ++count;
+    }
+
+    // turn the ids into ranks
+    for (int i = 0; i < count; ++i)
+    {
+        int coreRank = 0;
+        int sibling  = 0;
+
+        for (int j = 0; j < count; ++j)
+        {
+            if (cpus[j].package != cpus[i].package)
+                continue;
+
+            // count each earlier core of the socket once, at its first CPU
+            if (coreIds[j] < coreIds[i])
+            {
+                bool first = true;
+                for (int k = 0; k < j; ++k)
+                    if (cpus[k].package == cpus[j].package && coreIds[k] == coreIds[j])
+                        first = false;
+
+                if (first)
+                    ++coreRank;
+            }
+
+            if (coreIds[j] == coreIds[i] && j < i)
+                ++sibling;
+        }
+
+        cpus[i].core    = coreRank;
+        cpus[i].sibling = sibling;
+    }
+
+    delete [] coreIds;
+
+    return count;
+}
+
+/**
+ * @brief Reads a list of CPUs such as 0,2,4-7
+ *
+ * @param list      The list
+ * @param cpus      The array to fill
+ * @param maxCpus   The size of the array
+ * @return int      How many CPUs were read
+ */
+int parseCpuList(const string& list, int* cpus, const int maxCpus)
+{
+    stringstream ss(list);
+    string       range;
+    int          count = 0;
+
+    while (getline(ss, range, ',') && count < maxCpus)
+    {
+        size_t dash = range.find('-');
+
+        try
+        {
+            int first = stoi(range.substr(0, dash));
+            int last  = (dash == string::npos) ? first : stoi(range.substr(dash + 1));
+
+            for (int c = first; c <= last && count < maxCpus; ++c)
+                cpus[count++] = c;
+        }
+        catch (const exception&)
+        {
+            cout << "Ignoring \"" << range << "\" in the CPU list\n";
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Picks a CPU for every worker thread.
+ *          Compact fills the hardware threads of a core, then the
+ *          cores of a socket, before moving on. Scatter gives each
+ *          worker its own core, alternating between sockets, and only
+ *          doubles up on hardware threads once every core is in use.
+ *          A list is used in order. The workers take the order from
+ *          the offset on, and those past its end wrap around to its start.
+ *
+ * @param params        The parameters of the run
+ * @param numThreads    How many workers there are
+ * @param placement     The CPU of each worker, to fill
+ * @param offset        The position in the order of the first worker
+ * @return int          How many workers were placed (0 leaves them unpinned)
+ */
+int placeThreads(Parameters params, const int numThreads, int* placement, const int offset)
+{
+    if (params.affinity == AFFINITY_NONE)
+        return 0;
+
+    const int maxCpus = CPU_SETSIZE;
+    int*      order   = new int[maxCpus];
+    int       count   = 0;
+
+    if (params.affinity == AFFINITY_LIST)
+        count = parseCpuList(params.cpuList, order, maxCpus);
+    else
+    {
+        CpuInfo* cpus = new CpuInfo[maxCpus];
+        count = readTopology(cpus, maxCpus);
+
+        if (params.affinity == AFFINITY_COMPACT)
+        {
+            sort(cpus, cpus + count, [](const CpuInfo& a, const CpuInfo& b) {
+                if (a.package != b.package) return a.package < b.package;
+                if (a.core    != b.core)    return a.core    < b.core;
+                return a.sibling < b.sibling;
+            });
+        }
+        else
+        {
+            sort(cpus, cpus + count, [](const CpuInfo& a, const CpuInfo& b) {
+                if (a.sibling != b.sibling) return a.sibling < b.sibling;
+                if (a.core    != b.core)    return a.core    < b.core;
+                return a.package < b.package;
+            });
+        }
+
+        for (int i = 0; i < count; ++i)
+            order[i] = cpus[i].cpu;
+
+        delete [] cpus;
+    }
+
+    for (int i = 0; i < numThreads && count > 0; ++i)
+        placement[i] = order[(offset + i) % count];
+
+    delete [] order;
+
+    return (count > 0) ? numThreads : 0;
+}
+
+/**
+ * @brief Pins every worker of a pool to the CPU picked for it
+ *
+ * @param params    The parameters of the run
+ * @param pool      The pool whose workers are pinned
+ * @param offset    The position in the placement order of the first worker
+ */
+void pinThreads(Parameters params, ThreadPool* pool, const int offset)
+{
+    int* placement = new int[pool->getNumThreads()];
+    int  placed    = placeThreads(params, pool->getNumThreads(), placement, offset);
+
+    for (int i = 0; i < placed; ++i)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(placement[i], &set);
+
+        if (pthread_setaffinity_np(pool->getNativeHandle(i), sizeof(set), &set) != 0)
+            cout << "Could not pin worker " << i << " to CPU " << placement[i] << '\n';
+    }
+
+    delete [] placement;
+}
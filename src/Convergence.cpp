@@ -0,0 +1,214 @@
+/**
+ * @file Convergence.cpp
+ * @author Matthew Harker
+ * @brief Combines the records of independent replicates into
+ *          mean, median, and quantile convergence curves
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include "Convergence.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Convergence:: Convergence object
+ *          holding a single replicate
+ *
+ * @param rk    The records of the replicate
+ * @param curve Which history of the records to follow
+ */
+Convergence::Convergence(RecordKeeper* rk, Curve curve)
+{
+    experimentations = rk->getExperimentations();
+    count            = 1;
+    values           = new double[experimentations];
+
+    for (int i = 0; i < experimentations; ++i)
+        values[i] = (rk->*curve)(i);
+}
+
+/**
+ * @brief Construct a new Convergence:: Convergence object by merging
+ *          the sorted values of two groups, experiment by experiment
+ *
+ * @param first     The first group
+ * @param second    The second group
+ */
+Convergence::Convergence(Convergence* first, Convergence* second)
+{
+    experimentations = first->experimentations;
+    count            = first->count + second->count;
+    values           = new double[experimentations * count];
+
+    for (int i = 0; i < experimentations; ++i)
+    {
+        double* a   = first->values + i * first->count;
+        double* b   = second->values + i * second->count;
+        double* out = values + i * count;
+        int     x   = 0;
+        int     y   = 0;
+
+        while (x < first->count && y < second->count)
+            *out++ = (b[y] < a[x]) ? b[y++] : a[x++];
+
+        while (x < first->count)
+            *out++ = a[x++];
+
+        while (y < second->count)
+            *out++ = b[y++];
+    }
+}
+
+/**
+ * @brief Destroy the Convergence:: Convergence object
+ *
+ */
+Convergence::~Convergence()
+{
+    if (values != nullptr)
+        delete [] values;
+}
+
+/**
+ * @brief Returns how many experiments each replicate ran
+ *
+ * @return int experimentations
+ */
+int Convergence::getExperimentations()
+{
+    return experimentations;
+}
+
+/**
+ * @brief Returns how many replicates are in the group
+ *
+ * @return int count
+ */
+int Convergence::getCount()
+{
+    return count;
+}
+
+/**
+ * @brief Returns the mean over the replicates of an experiment.
+ *          The values are summed in sorted order, so the result does
+ *          not depend on the shape of the reduction.
+ *
+ * @param experiment    The experiment
+ * @return double       The mean
+ */
+double Convergence::getMean(const int experiment)
+{
+    double* row = values + experiment * count;
+    double  sum = 0;
+
+    for (int i = 0; i < count; ++i)
+        sum += row[i];
+
+    return sum / count;
+}
+
+/**
+ * @brief Returns a quantile over the replicates of an experiment,
+ *          interpolating linearly between the closest two values
+ *
+ * @param experiment    The experiment
+ * @param q             The quantile, in [0, 1] (0.5 is the median)
+ * @return double       The quantile
+ */
+double Convergence::getQuantile(const int experiment, double q)
+{
+    double* row  = values + experiment * count;
+    double  pos  = q * (count - 1);
+    int     low  = int(pos);
+    int     high = (low + 1 < count) ? low + 1 : low;
+
+    return row[low] + (pos - low) * (row[high] - row[low]);
+}
+
+/**
+ * @brief Merges the replicates [from, to) of one function, splitting the
+ *          range in half and merging the halves on the pool
+ *
+ * @param reps          The records of every replicate of the function
+ * @param from          The first replicate
+ * @param to            One past the last replicate
+ * @param curve         Which history of the records to follow
+ * @param pool          The pool of threads to run on
+ * @return Convergence* The merged group
+ */
+static Convergence* reduceRange(RecordKeeper** reps, const int from, const int to,
+                                Curve curve, ThreadPool* pool)
+{
+    if (to - from == 1)
+        return new Convergence(reps[from], curve);
+
+    int          mid    = from + (to - from) / 2;
+    Convergence* first  = nullptr;
+    Convergence* second = nullptr;
+    TaskGroup    group;
+
+    pool->submit(&group, [&]{ first = reduceRange(reps, from, mid, curve, pool); }, mid - from);
+    second = reduceRange(reps, mid, to, curve, pool);
+    pool->wait(&group);
+
+    Convergence* merged = new Convergence(first, second);
+
+    delete first;
+    delete second;
+
+    return merged;
+}
+
+/**
+ * @brief Merges the records of every replicate into one group per function.
+ *          The records are laid out replicate by replicate, each one
+ *          holding every function. The functions are reduced at the same
+ *          time and each one is reduced as a tree.
+ *
+ * @param rks           The records of every replicate
+ * @param replicates    How many replicates there are
+ * @param curve         Which history of the records to follow
+ * @param pool          The pool of threads to run on
+ * @return Convergence** The merged group of each function
+ */
+Convergence** reduceReplicates(RecordKeeper** rks, const int replicates, Curve curve, ThreadPool* pool)
+{
+    int           numFuncs = rks[0]->getNumFuncs();
+    Convergence** curves   = new Convergence*[numFuncs];
+    TaskGroup     group;
+
+    for (int f = 0; f < numFuncs; ++f)
+    {
+        pool->submit(&group, [=]{
+            // gather the replicates of the function
+            RecordKeeper** reps = new RecordKeeper*[replicates];
+            for (int r = 0; r < replicates; ++r)
+                reps[r] = rks[r * numFuncs + f];
+
+            curves[f] = reduceRange(reps, 0, replicates, curve, pool);
+
+            delete [] reps;
+        }, replicates);
+    }
+
+    pool->wait(&group);
+
+    return curves;
+}
+
+/**
+ * @brief Destroys the merged group of every function
+ *
+ * @param curves    The array to destroy
+ * @param numFuncs  How many functions there are
+ */
+void destroyConvergence(Convergence** curves, const int numFuncs)
+{
+    for (int i = 0; i < numFuncs; ++i)
+        delete curves[i];
+    delete [] curves;
+}
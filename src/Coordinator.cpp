@@ -0,0 +1,512 @@
+/**
+ * @file Coordinator.cpp
+ * @author Matthew Harker
+ * @brief Shards the runs of a campaign across worker processes of this
+ *          executable, talking to them over a Unix domain socket
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Affinity.h"
+#include "Coordinator.h"
+#include "differentialEvolution.h"
+#include "firefly.h"
+#include "harmony.h"
+#include "Island.h"
+#include "particleSwarm.h"
+#include "Random.h"
+
+using namespace std;
+
+// the optimizer and migration of each algorithm, indexed by Algorithm
+static const OptimizerMaker makers[]    = { makeParticleSwarm, makeFirefly, makeHarmony,
+                                            makeDifferentialEvolution };
+static const Acceptor       acceptors[] = { acceptParticle, acceptFirefly, acceptHarmony,
+                                            acceptDifferential };
+
+// how many times each worker may be restarted before the campaign gives up
+static const int RESTARTS_PER_WORKER = 3;
+
+/**
+ * @brief Returns how many jobs a campaign has
+ *
+ * @param params    The parameters of the run
+ * @return int      algorithms x replicates x functions
+ */
+int jobCount(Parameters params)
+{
+    return 4 * params.replicates * params.numFuncs;
+}
+
+/**
+ * @brief Runs a single job, the same way the in process campaign does
+ *
+ * @param params    The parameters of the run
+ * @param job       The job to run
+ * @param rk        Where the records of the job are kept
+ * @param pool      The pool the run's sweeps and islands are split across
+ */
+void runJob(Parameters params, const int job, RecordKeeper* rk, ThreadPool* pool)
+{
+    int perAlg    = params.replicates * params.numFuncs;
+    int algorithm = job / perAlg;
+    int replicate = (job % perAlg) / params.numFuncs;
+    int function  = job % params.numFuncs;
+
+    params.seed = replicateSeed(params.seed, replicate);
+
+    Population pop(params, function);
+    pop.setThreadPool(pool);
+
+    runIslands(&pop, rk, makers[algorithm], acceptors[algorithm]);
+}
+
+/**
+ * @brief Reads exactly size bytes from a socket
+ *
+ * @param fd        The socket
+ * @param data      Where the bytes go
+ * @param size      How many bytes to read
+ * @return true     Every byte was read
+ * @return false    The other end closed or failed first
+ */
+static bool readFully(int fd, void* data, size_t size)
+{
+    char* at = static_cast<char*>(data);
+
+    while (size > 0)
+    {
+        ssize_t got = read(fd, at, size);
+
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+
+        at   += got;
+        size -= got;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes exactly size bytes to a socket
+ *
+ * @param fd        The socket
+ * @param data      The bytes to write
+ * @param size      How many bytes to write
+ * @return true     Every byte was written
+ * @return false    The other end closed or failed first
+ */
+static bool writeFully(int fd, const void* data, size_t size)
+{
+    const char* at = static_cast<const char*>(data);
+
+    while (size > 0)
+    {
+        ssize_t put = send(fd, at, size, MSG_NOSIGNAL);
+
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return false;
+
+        at   += put;
+        size -= put;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Starts a worker process of this executable
+ *
+ * @param socketPath    The socket the worker connects back to
+ * @param index         Which worker it is
+ * @return pid_t        The process id of the worker (-1 on failure)
+ */
+static pid_t spawnWorker(const string& socketPath, const int index)
+{
+    string number = to_string(index);
+    pid_t  pid    = fork();
+
+    if (pid == 0)
+    {
+        execl("/proc/self/exe", "cs471_proj_4.out", "--worker", socketPath.c_str(), number.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+// what the coordinator knows about one worker
+struct WorkerSlot
+{
+    pid_t pid;          // the process (-1 when there is none)
+    int   fd;           // the connection (-1 until the worker connects)
+    int   shard;        // the shard being run (-1 when idle)
+    int   owed;         // how many results of the shard are still to come
+};
+
+/**
+ * @brief Runs a campaign on worker processes. The jobs are cut into
+ *          shards that are handed to whichever worker is idle. Every
+ *          result is sent back as soon as its job finishes, so when a
+ *          worker dies only the unfinished jobs of its shard are run
+ *          again, on a freshly started worker. Runs are keyed by the
+ *          seed, so a job that is run again gives the same records.
+ *
+ * @param params    The parameters of the run
+ * @param rks       The RecordKeeper array of each algorithm, to fill
+ * @return int      0 on success, 1 if the campaign could not finish
+ */
+int runCoordinator(Parameters params, RecordKeeper*** rks)
+{
+    int workers = params.processes;
+    int jobs    = jobCount(params);
+    int perAlg  = params.replicates * params.numFuncs;
+
+    // a few shards per worker, so a restart repeats little work
+    int shards = (jobs < 4 * workers) ? jobs : 4 * workers;
+
+    int*  shardOf = new int[jobs];
+    bool* done    = new bool[jobs];
+    bool* queued  = new bool[shards];
+    int   left    = jobs;
+
+    for (int j = 0; j < jobs; ++j)
+    {
+        shardOf[j] = j % shards;
+        done[j]    = false;
+    }
+    for (int s = 0; s < shards; ++s)
+        queued[s] = true;
+
+    // listen on a socket named after this process
+    string socketPath = "/tmp/cs471_proj_4." + to_string(getpid()) + ".sock";
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    unlink(socketPath.c_str());
+    if (listener < 0
+        || bind(listener, (sockaddr*)&address, sizeof(address)) != 0
+        || listen(listener, workers) != 0)
+    {
+        cout << "Could not open the coordinator socket " << socketPath << '\n';
+        exit(EXIT_FAILURE);
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    WorkerSlot* slots    = new WorkerSlot[workers];
+    int         restarts = RESTARTS_PER_WORKER * workers;
+
+    for (int w = 0; w < workers; ++w)
+    {
+        slots[w].pid   = spawnWorker(socketPath, w);
+        slots[w].fd    = -1;
+        slots[w].shard = -1;
+        slots[w].owed  = 0;
+    }
+
+    int     recordSize = rks[0][0]->getPackedSize();
+    double* record     = new double[recordSize];
+    bool    failed     = false;
+
+    pollfd* fds = new pollfd[workers + 1];
+
+    while (left > 0 && !failed)
+    {
+        // hand a queued shard to every idle worker
+        for (int w = 0; w < workers; ++w)
+        {
+            if (slots[w].fd < 0 || slots[w].shard >= 0)
+                continue;
+
+            int shard = -1;
+            for (int s = 0; s < shards && shard < 0; ++s)
+                if (queued[s])
+                    shard = s;
+
+            if (shard < 0)
+                break;
+
+            // send the seed and the unfinished jobs of the shard
+            int32_t count = 0;
+            for (int j = 0; j < jobs; ++j)
+                if (shardOf[j] == shard && !done[j])
+                    ++count;
+
+            uint64_t seed = params.seed;
+            bool     sent = writeFully(slots[w].fd, &seed, sizeof(seed))
+                         && writeFully(slots[w].fd, &count, sizeof(count));
+
+            for (int32_t j = 0; j < jobs && sent; ++j)
+                if (shardOf[j] == shard && !done[j])
+                    sent = writeFully(slots[w].fd, &j, sizeof(j));
+
+            queued[shard]  = false;
+            slots[w].shard = shard;
+            slots[w].owed  = count;
+        }
+
+        // wait for a connection or a result
+        fds[0].fd     = listener;
+        fds[0].events = POLLIN;
+        for (int w = 0; w < workers; ++w)
+        {
+            fds[w + 1].fd     = slots[w].fd;
+            fds[w + 1].events = POLLIN;
+        }
+
+        poll(fds, workers + 1, 100);
+
+        // a new worker introduces itself with its process id
+        if (fds[0].revents & POLLIN)
+        {
+            int   fd  = accept(listener, nullptr, nullptr);
+            pid_t pid = -1;
+
+            if (fd >= 0 && readFully(fd, &pid, sizeof(pid)))
+            {
+                for (int w = 0; w < workers; ++w)
+                {
+                    if (slots[w].pid == pid)
+                    {
+                        slots[w].fd = fd;
+                        fd = -1;
+                    }
+                }
+            }
+
+            if (fd >= 0)
+                close(fd);
+        }
+
+        for (int w = 0; w < workers; ++w)
+        {
+            bool lost = false;
+
+            // take in a finished job
+            if (slots[w].fd >= 0 && (fds[w + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+                int32_t job;
+
+                if (readFully(slots[w].fd, &job, sizeof(job))
+                    && job >= 0 && job < jobs
+                    && readFully(slots[w].fd, record, recordSize * sizeof(double)))
+                {
+                    if (!done[job])
+                    {
+                        rks[job / perAlg][job % perAlg]->unpack(record);
+                        done[job] = true;
+                        --left;
+                    }
+
+                    if (--slots[w].owed == 0)
+                        slots[w].shard = -1;
+                }
+                else
+                    lost = true;
+            }
+
+            // a worker that could not be started is lost right away
+            if (!lost && slots[w].pid < 0 && slots[w].fd < 0)
+            {
+                cout << "Worker " << w << " could not be started\n";
+                lost = true;
+            }
+
+            // a worker can also die before it ever connects
+            if (!lost && slots[w].pid > 0 && waitpid(slots[w].pid, nullptr, WNOHANG) == slots[w].pid)
+            {
+                slots[w].pid = -1;
+                lost = (slots[w].fd < 0 || slots[w].shard >= 0);
+            }
+
+            if (!lost)
+                continue;
+
+            // put the unfinished part of the shard back and start a new worker
+            if (slots[w].shard >= 0)
+            {
+                cout << "Worker " << w << " failed, its shard will be run again\n";
+                queued[slots[w].shard] = true;
+            }
+
+            if (slots[w].fd >= 0)
+                close(slots[w].fd);
+
+            if (slots[w].pid > 0)
+            {
+                kill(slots[w].pid, SIGKILL);
+                waitpid(slots[w].pid, nullptr, 0);
+            }
+
+            slots[w].fd    = -1;
+            slots[w].shard = -1;
+            slots[w].owed  = 0;
+            slots[w].pid   = -1;
+
+            if (restarts-- > 0)
+                slots[w].pid = spawnWorker(socketPath, w);
+            else
+                failed = true;
+        }
+    }
+
+    // tell every worker to stop, with an empty shard
+    for (int w = 0; w < workers; ++w)
+    {
+        if (slots[w].fd >= 0)
+        {
+            uint64_t seed  = params.seed;
+            int32_t  count = 0;
+
+            writeFully(slots[w].fd, &seed, sizeof(seed));
+            writeFully(slots[w].fd, &count, sizeof(count));
+            close(slots[w].fd);
+        }
+
+        if (slots[w].pid > 0)
+            waitpid(slots[w].pid, nullptr, 0);
+    }
+
+    close(listener);
+    unlink(socketPath.c_str());
+
+    delete [] fds;
+    delete [] record;
+    delete [] slots;
+    delete [] shardOf;
+    delete [] done;
+    delete [] queued;
+
+    if (failed)
+    {
+        cout << "Too many workers failed, the campaign was not finished\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Runs as a worker of a coordinator. The worker connects to the
+ *          coordinator's socket, then runs each shard it is sent on its
+ *          own thread pool, sending back every job's records as soon as
+ *          the job finishes. An empty shard stops the worker. Without
+ *          a set number of threads, the hardware threads are split
+ *          evenly between the workers, and each worker pins its threads
+ *          to its own slice of the placement order.
+ *
+ * @param socketPath    The socket of the coordinator
+ * @param index         Which worker this is
+ * @return int          0 once the coordinator is done with the worker
+ */
+int runWorker(const char* socketPath, const int index)
+{
+    Parameters params = getParameters();
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+    if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0)
+        return 1;
+
+    pid_t pid = getpid();
+    if (!writeFully(fd, &pid, sizeof(pid)))
+        return 1;
+
+    // the workers share the machine, so by default each gets its share of it
+    int threads = params.numThreads;
+    if (threads <= 0 && params.processes > 0)
+    {
+        threads = int(thread::hardware_concurrency()) / params.processes;
+        if (threads < 1)
+            threads = 1;
+    }
+
+    ThreadPool pool(threads);
+    mutex      sendLock;
+
+    // keep the workers' threads on different CPUs if asked to
+    pinThreads(params, &pool, index * pool.getNumThreads());
+
+    while (true)
+    {
+        uint64_t seed;
+        int32_t  count;
+
+        if (!readFully(fd, &seed, sizeof(seed)) || !readFully(fd, &count, sizeof(count)))
+            return 1;
+
+        if (count == 0)
+            break;
+
+        // every replicate seed is derived from the coordinator's seed
+        params.seed = seed;
+
+        int32_t* jobs = new int32_t[count];
+        if (!readFully(fd, jobs, count * sizeof(int32_t)))
+            return 1;
+
+        TaskGroup shard;
+
+        for (int i = 0; i < count; ++i)
+        {
+            int32_t job = jobs[i];
+
+            pool.submit(&shard, [&, job]{
+                RecordKeeper rk(params);
+                runJob(params, job, &rk, &pool);
+
+                double* record = new double[rk.getPackedSize()];
+                rk.pack(record);
+
+                {
+                    lock_guard<mutex> guard(sendLock);
+                    writeFully(fd, &job, sizeof(job));
+                    writeFully(fd, record, rk.getPackedSize() * sizeof(double));
+                }
+
+                delete [] record;
+            }, 1.0);
+        }
+
+        pool.wait(&shard);
+
+        delete [] jobs;
+    }
+
+    close(fd);
+
+    return 0;
+}
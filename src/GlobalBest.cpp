@@ -0,0 +1,167 @@
+/**
+ * @file GlobalBest.cpp
+ * @author Matthew Harker
+ * @brief A global best solution that many threads can offer to and
+ *          read from without taking a lock
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <cfloat>
+#include <thread>
+
+#include "GlobalBest.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Global Best:: Global Best object with no
+ *          solution (a fitness of DBL_MAX)
+ *
+ * @param solutionSize The size of the solution
+ */
+GlobalBest::GlobalBest(const int solutionSize)
+{
+    size     = solutionSize;
+    solution = new atomic<double>[size];
+
+    reset();
+}
+
+/**
+ * @brief Destroy the Global Best:: Global Best object
+ *
+ */
+GlobalBest::~GlobalBest()
+{
+    if (solution != nullptr)
+        delete [] solution;
+}
+
+/**
+ * @brief Forgets the solution. Only call this while no other
+ *          thread is using the object.
+ *
+ */
+void GlobalBest::reset()
+{
+    sequence = 0;
+    fitness  = DBL_MAX;
+    round    = -1;
+    index    = -1;
+
+    for (int i = 0; i < size; ++i)
+        solution[i].store(0.0, memory_order_relaxed);
+}
+
+/**
+ * @brief Offers a solution. It replaces the current one if it is
+ *          strictly better, or if it ties with a solution offered in
+ *          the same round at a higher index; so the result of a round
+ *          does not depend on the order of its offers.
+ *
+ * @param newSolution   The solution
+ * @param newFitness    The fitness of the solution
+ * @param newRound      The round the offer belongs to
+ * @param newIndex      The index of the solution within the round
+ * @return true         The solution was taken
+ * @return false        The current solution is at least as good
+ */
+bool GlobalBest::offer(const double* newSolution, double newFitness, const int newRound, const int newIndex)
+{
+    // most offers lose, and can tell without writing anything
+    if (newFitness > fitness.load(memory_order_acquire))
+        return false;
+
+    // claim the sequence number
+    unsigned seq = sequence.load(memory_order_relaxed);
+    while (true)
+    {
+        if ((seq & 1) == 0 && sequence.compare_exchange_weak(seq, seq + 1, memory_order_acquire))
+            break;
+
+        // another writer holds it, so let it finish
+        if (seq & 1)
+            this_thread::yield();
+
+        seq = sequence.load(memory_order_relaxed);
+    }
+
+    // the odd sequence must be visible before any of the stores below
+    atomic_thread_fence(memory_order_release);
+
+    double current = fitness.load(memory_order_relaxed);
+    bool   wins    = newFitness < current
+                  || (newFitness == current && newRound == round && newIndex < index);
+
+    if (wins)
+    {
+        for (int i = 0; i < size; ++i)
+            solution[i].store(newSolution[i], memory_order_relaxed);
+
+        round = newRound;
+        index = newIndex;
+        fitness.store(newFitness, memory_order_relaxed);
+    }
+
+    // release it, publishing the new solution
+    sequence.store(seq + 2, memory_order_release);
+
+    return wins;
+}
+
+/**
+ * @brief Returns the fitness of the solution
+ *
+ * @return double The fitness (DBL_MAX if there is none)
+ */
+double GlobalBest::getFitness()
+{
+    return fitness.load(memory_order_acquire);
+}
+
+/**
+ * @brief Returns one element of the solution. Elements read one at a
+ *          time may come from different solutions while offers are
+ *          being made; use read() for a consistent copy.
+ *
+ * @param elem      The element
+ * @return double   The value of the element
+ */
+double GlobalBest::getElement(const int elem)
+{
+    return solution[elem].load(memory_order_relaxed);
+}
+
+/**
+ * @brief Copies the solution, trying again until the copy was not
+ *          overlapped by a writer
+ *
+ * @param out       Where the solution is copied to
+ * @return double   The fitness of the copied solution
+ */
+double GlobalBest::read(double* out)
+{
+    while (true)
+    {
+        unsigned before = sequence.load(memory_order_acquire);
+
+        // a writer is part way through, so let it finish
+        if (before & 1)
+        {
+            this_thread::yield();
+            continue;
+        }
+
+        for (int i = 0; i < size; ++i)
+            out[i] = solution[i].load(memory_order_relaxed);
+
+        double fit = fitness.load(memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (sequence.load(memory_order_relaxed) == before)
+            return fit;
+    }
+}
@@ -0,0 +1,574 @@
+/**
+ * @file Island.cpp
+ * @author Matthew Harker
+ * @brief Splits a population into islands that run side by side and
+ *          trade their best solutions through lock free queues
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <cfloat>
+
+#include "Island.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Migration Queue:: Migration Queue object
+ *
+ * @param minCapacity   The fewest migrants the queue must hold
+ * @param size          The size of each migrant
+ */
+MigrationQueue::MigrationQueue(const int minCapacity, const int size)
+{
+    capacity = 1;
+    while (capacity < unsigned(minCapacity))
+        capacity <<= 1;
+
+    solutionSize = size;
+    slots        = new double[capacity * (solutionSize + 1)];
+
+    head = 0;
+    tail = 0;
+}
+
+/**
+ * @brief Destroy the Migration Queue:: Migration Queue object
+ *
+ */
+MigrationQueue::~MigrationQueue()
+{
+    if (slots != nullptr)
+        delete [] slots;
+}
+
+/**
+ * @brief Adds a migrant to the queue. Only the sending island may call this.
+ *
+ * @param solution  The migrant
+ * @param fitness   The fitness of the migrant
+ * @return true     The migrant was queued
+ * @return false    The queue was full and the migrant was dropped
+ */
+bool MigrationQueue::push(double* solution, double fitness)
+{
+    unsigned back = tail.load(memory_order_relaxed);
+
+    if (back - head.load(memory_order_acquire) == capacity)
+        return false;
+
+    double* slot = slots + (back & (capacity - 1)) * (solutionSize + 1);
+    for (int i = 0; i < solutionSize; ++i)
+        slot[i] = solution[i];
+    slot[solutionSize] = fitness;
+
+    // publish the slot only once it is written
+    tail.store(back + 1, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Takes the oldest migrant from the queue. Only the receiving
+ *          island may call this.
+ *
+ * @param solution  Where the migrant is copied to
+ * @param fitness   The fitness of the migrant
+ * @return true     A migrant was taken
+ * @return false    The queue was empty
+ */
+bool MigrationQueue::pop(double* solution, double& fitness)
+{
+    unsigned front = head.load(memory_order_relaxed);
+
+    if (front == tail.load(memory_order_acquire))
+        return false;
+
+    double* slot = slots + (front & (capacity - 1)) * (solutionSize + 1);
+    for (int i = 0; i < solutionSize; ++i)
+        solution[i] = slot[i];
+    fitness = slot[solutionSize];
+
+    // hand the slot back only once it is read
+    head.store(front + 1, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Construct a new Island:: Island object with no links
+ *
+ */
+Island::Island()
+{
+    interval = 1;
+    migrants = 0;
+    numOut   = 0;
+    numIn    = 0;
+    accept   = nullptr;
+}
+
+/**
+ * @brief Sets how the island migrates
+ *
+ * @param newInterval   Generations between migrations
+ * @param newMigrants   How many elites are sent per migration
+ * @param newAccept     Takes a migrant into the population
+ */
+void Island::setup(const int newInterval, const int newMigrants, Acceptor newAccept)
+{
+    interval = (newInterval > 0) ? newInterval : 1;
+    migrants = newMigrants;
+    accept   = newAccept;
+}
+
+/**
+ * @brief Links the island to a downstream neighbour
+ *
+ * @param queue The queue the island sends to
+ */
+void Island::addOutbound(MigrationQueue* queue)
+{
+    outbound[numOut++] = queue;
+}
+
+/**
+ * @brief Links the island to an upstream neighbour
+ *
+ * @param queue The queue the island receives from
+ */
+void Island::addInbound(MigrationQueue* queue)
+{
+    inbound[numIn++] = queue;
+}
+
+/**
+ * @brief Sends copies of the best solutions to every downstream
+ *          neighbour, then takes in every migrant that has arrived.
+ *
+ * @param pop           The population of the island
+ * @param generation    The generation that just finished
+ */
+void Island::migrate(Population* pop, const int generation)
+{
+    if ((generation + 1) % interval != 0)
+        return;
+
+    int size  = pop->getPopSize();
+    int count = (migrants < size) ? migrants : size;
+
+    // pick the elites by selection, so the population is left as it is
+    int* order = new int[size];
+    for (int i = 0; i < size; ++i)
+        order[i] = i;
+
+    for (int i = 0; i < count; ++i)
+    {
+        int best = i;
+        for (int j = i + 1; j < size; ++j)
+            if (pop->getFitness(order[j]) < pop->getFitness(order[best]))
+                best = j;
+
+        int temp    = order[i];
+        order[i]    = order[best];
+        order[best] = temp;
+
+        for (int q = 0; q < numOut; ++q)
+            outbound[q]->push(pop->getPopulation(order[i]), pop->getFitness(order[i]));
+    }
+
+    delete [] order;
+
+    // take in whatever the upstream islands have sent so far
+    double* migrant = new double[pop->getSolutionSize()];
+    double  fitness;
+
+    for (int q = 0; q < numIn; ++q)
+        while (inbound[q]->pop(migrant, fitness))
+            accept(pop, migrant, fitness);
+
+    delete [] migrant;
+}
+
+/**
+ * @brief Construct a new Island Optimizer:: Island Optimizer object.
+ *          Each island gets an even share of the solutions, its own
+ *          random streams, and the population's pool.
+ *
+ * @param newPop    The population to split
+ * @param newRk     Records the information of the whole population
+ * @param make      Builds the algorithm's optimizer for one island
+ * @param accept    Takes a migrant into an island
+ */
+IslandOptimizer::IslandOptimizer(Population* newPop, RecordKeeper* newRk, OptimizerMaker make, Acceptor accept)
+    : Optimizer(newPop, newRk)
+{
+    Parameters params = pop->getParameters();
+    int        whole  = params.popSize;
+    int        budget = params.psoBudget;
+
+    count     = params.islands;
+    lockstep  = params.lockstep != 0;
+    pops      = new Population*[count];
+    rks       = new RecordKeeper*[count];
+    runs      = new Optimizer*[count];
+    islands   = new Island[count];
+    queues    = new MigrationQueue*[2 * count];
+    numQueues = 0;
+
+    // split the solutions as evenly as possible
+    for (int k = 0; k < count; ++k)
+    {
+        params.popSize = whole / count + ((k < whole % count) ? 1 : 0);
+
+        // each island gets a share of the evaluation budget (0 stays unlimited)
+        if (budget > 0)
+        {
+            params.psoBudget = int((long long)budget * params.popSize / whole);
+            if (params.psoBudget < 1)
+                params.psoBudget = 1;
+        }
+
+        pops[k] = new Population(params, pop->getFunction());
+        pops[k]->setIsland(k);
+        pops[k]->setThreadPool(pop->getThreadPool());
+
+        rks[k]  = new RecordKeeper(params);
+        runs[k] = make(pops[k], rks[k]);
+
+        islands[k].setup(params.migrationInterval, params.migrants, accept);
+    }
+
+    // a ring sends to the next island, a torus to the right and below
+    int rows = 1;
+    int cols = count;
+
+    if (params.topology == TOPO_TORUS)
+    {
+        for (int r = 1; r * r <= count; ++r)
+            if (count % r == 0)
+                rows = r;
+
+        cols = count / rows;
+    }
+
+    for (int k = 0; k < count; ++k)
+    {
+        int row = k / cols;
+        int col = k % cols;
+        int neighbours[2] = { row * cols + (col + 1) % cols,
+                              ((row + 1) % rows) * cols + col };
+
+        for (int n = 0; n < 2; ++n)
+        {
+            int to = neighbours[n];
+
+            if (to == k || (n == 1 && to == neighbours[0]))
+                continue;
+
+            MigrationQueue* queue = new MigrationQueue(4 * params.migrants, params.numDims);
+            queues[numQueues++] = queue;
+
+            islands[k].addOutbound(queue);
+            islands[to].addInbound(queue);
+        }
+    }
+}
+
+/**
+ * @brief Destroy the Island Optimizer:: Island Optimizer object
+ *
+ */
+IslandOptimizer::~IslandOptimizer()
+{
+    for (int k = 0; k < count; ++k)
+    {
+        delete runs[k];
+        delete pops[k];
+        delete rks[k];
+    }
+    for (int q = 0; q < numQueues; ++q)
+        delete queues[q];
+
+    delete [] runs;
+    delete [] pops;
+    delete [] rks;
+    delete [] islands;
+    delete [] queues;
+}
+
+/**
+ * @brief Runs something for every island, as tasks on the pool if
+ *          there is one, and waits until all are done
+ *
+ * @param body What to run, given the index of the island
+ */
+void IslandOptimizer::forEachIsland(function<void(int)> body)
+{
+    ThreadPool* pool = pop->getThreadPool();
+
+    if (pool == nullptr)
+    {
+        for (int k = 0; k < count; ++k)
+            body(k);
+        return;
+    }
+
+    pool->parallelFor(0, count, 1, [=](int from, int to) {
+        for (int k = from; k < to; ++k)
+            body(k);
+    });
+}
+
+/**
+ * @brief Builds the starting population of every island
+ *
+ */
+void IslandOptimizer::initialize()
+{
+    forEachIsland([=](int k) { runs[k]->start(); });
+}
+
+/**
+ * @brief Runs a generation on every island, then migrates, in
+ *          lockstep. The islands send and receive one after another
+ *          in order.
+ *
+ * @param gen The generation being run
+ */
+void IslandOptimizer::generate(const int gen)
+{
+    forEachIsland([=](int k) { runs[k]->step(); });
+
+    for (int k = 0; k < count; ++k)
+        islands[k].migrate(pops[k], gen);
+}
+
+/**
+ * @brief Returns the best fitness of the last generation over every
+ *          island, as the islands' records are only merged at the end
+ *
+ * @return double The best fitness
+ */
+double IslandOptimizer::getBestFit()
+{
+    double best = rks[0]->getHistoricBestFit(generation - 1);
+
+    for (int k = 1; k < count; ++k)
+        if (rks[k]->getHistoricBestFit(generation - 1) < best)
+            best = rks[k]->getHistoricBestFit(generation - 1);
+
+    return best;
+}
+
+/**
+ * @brief Returns the highest diversity of any island after the last
+ *          generation, so the run only stops once every island has
+ *          collapsed
+ *
+ * @return double The rms distance to the centroid, over the range width
+ */
+double IslandOptimizer::getDiversity()
+{
+    double most = pops[0]->getDiversity();
+
+    for (int k = 1; k < count; ++k)
+        if (pops[k]->getDiversity() > most)
+            most = pops[k]->getDiversity();
+
+    return most;
+}
+
+/**
+ * @brief Records the final results of every island and merges them
+ *          into the records of the whole population
+ *
+ */
+void IslandOptimizer::finish()
+{
+    forEachIsland([=](int k) { runs[k]->finish(); });
+
+    mergeIslandRecords(rk, rks, pops, count);
+}
+
+/**
+ * @brief Runs the islands on the pool. In lockstep the islands run a
+ *          generation at a time as one optimizer. Otherwise each island
+ *          is scheduled as its own chain of tasks, and the last island
+ *          to finish merges the records.
+ *
+ * @param pool  The pool of threads to run on
+ * @param group The group the tasks are added to
+ * @param cost  The expected cost of the whole optimization
+ * @param done  What to do once the optimization is done
+ */
+void IslandOptimizer::schedule(ThreadPool* pool, TaskGroup* group, double cost, function<void()> done)
+{
+    if (lockstep)
+    {
+        Optimizer::schedule(pool, group, cost, done);
+        return;
+    }
+
+    shared_ptr<atomic<int>> running(new atomic<int>(count));
+
+    for (int k = 0; k < count; ++k)
+        scheduleIsland(k, pool, group, cost / count, running, done);
+}
+
+/**
+ * @brief Runs the next piece of one island as a task, then migrates
+ *          and schedules the piece after it. The island only trades
+ *          with the queues, so it never waits for its neighbours.
+ *          The task is submitted rather than posted so a worker that
+ *          waits on the group, as a worker process does, can run it.
+ *
+ * @param k         The island
+ * @param pool      The pool of threads to run on
+ * @param group     The group the tasks are added to
+ * @param cost      The expected cost of the island's whole run
+ * @param running   How many islands have not finished
+ * @param done      What to do once every island is done
+ */
+void IslandOptimizer::scheduleIsland(const int k, ThreadPool* pool, TaskGroup* group, double cost,
+                                     shared_ptr<atomic<int>> running, function<void()> done)
+{
+    int    total = pops[k]->getExperimentations();
+    double left  = (total > 0) ? cost * (total - runs[k]->getGeneration()) / total : cost;
+
+    pool->submit(group, [=]{
+        if (runs[k]->resume())
+        {
+            // the starting population does not migrate
+            if (runs[k]->getGeneration() > 0)
+                islands[k].migrate(pops[k], runs[k]->getGeneration() - 1);
+
+            scheduleIsland(k, pool, group, cost, running, done);
+        }
+        else if (--*running == 0)
+        {
+            mergeIslandRecords(rk, rks, pops, count);
+            done();
+        }
+    }, left);
+}
+
+/**
+ * @brief Builds the optimizer of a population: the algorithm's own,
+ *          or a set of islands running it if the population is split
+ *
+ * @param pop       The population to optimize
+ * @param rk        Records the information of the whole population
+ * @param make      Builds the algorithm's optimizer
+ * @param accept    Takes a migrant into an island
+ * @return Optimizer* The optimizer, which the caller deletes
+ */
+Optimizer* makeOptimizer(Population* pop, RecordKeeper* rk, OptimizerMaker make, Acceptor accept)
+{
+    if (pop->getParameters().islands <= 1)
+        return make(pop, rk);
+
+    return new IslandOptimizer(pop, rk, make, accept);
+}
+
+/**
+ * @brief Runs a population, as a set of islands if it is split,
+ *          from start to finish. Islands that do not run in lockstep
+ *          are scheduled on the population's pool, which the calling
+ *          thread helps with until they are done.
+ *
+ * @param pop       The population to run
+ * @param rk        Records the information of the whole population
+ * @param make      Builds the algorithm's optimizer
+ * @param accept    Takes a migrant into an island
+ */
+void runIslands(Population* pop, RecordKeeper* rk, OptimizerMaker make, Acceptor accept)
+{
+    Optimizer*  opt    = makeOptimizer(pop, rk, make, accept);
+    Parameters  params = pop->getParameters();
+    ThreadPool* pool   = pop->getThreadPool();
+
+    if (params.islands > 1 && !params.lockstep && pool != nullptr)
+    {
+        TaskGroup group;
+
+        opt->schedule(pool, &group, 1.0, []{});
+        pool->wait(&group);
+    }
+    else
+        runOptimizer(opt);
+
+    delete opt;
+}
+
+/**
+ * @brief Merges the records of every island into the records of the
+ *          whole population. The best and worst are taken over every
+ *          island, the mean and variance are pooled, function calls
+ *          are added up, and the time is that of the slowest island.
+ *          The per solution records follow the islands in order.
+ *
+ * @param rk    The records of the whole population
+ * @param rks   The records of each island
+ * @param pops  The population of each island
+ * @param count How many islands there are
+ */
+void mergeIslandRecords(RecordKeeper* rk, RecordKeeper** rks, Population** pops, const int count)
+{
+    for (int e = 0; e < rk->getExperimentations(); ++e)
+    {
+        double best    = DBL_MAX;
+        double worst   = -DBL_MAX;
+        double gBest   = DBL_MAX;
+        double time    = 0;
+        int    calls   = 0;
+        int    total   = 0;
+        double sum     = 0;
+        double sumSq   = 0;
+        int    offset  = 0;
+
+        for (int k = 0; k < count; ++k)
+        {
+            int    size = pops[k]->getPopSize();
+            double mean = rks[k]->getHistoricMeanFit(e);
+
+            if (rks[k]->getHistoricBestFit(e) < best)   best  = rks[k]->getHistoricBestFit(e);
+            if (rks[k]->getHistoricWorstFit(e) > worst) worst = rks[k]->getHistoricWorstFit(e);
+            if (rks[k]->getHistoricGBest(e) < gBest)    gBest = rks[k]->getHistoricGBest(e);
+            if (rks[k]->getTimeTaken(e) > time)         time  = rks[k]->getTimeTaken(e);
+
+            calls += rks[k]->getFinalFuncCalls(e);
+            total += size;
+            sum   += size * mean;
+            sumSq += size * (rks[k]->getHistoricVarFit(e) + mean * mean);
+
+            for (int i = 0; i < size; ++i)
+            {
+                rk->setHistoricFit(rks[k]->getHistoricFit(i, e), offset + i, e);
+                rk->setHistoricPBest(rks[k]->getHistoricPBest(i, e), offset + i, e);
+            }
+
+            offset += size;
+        }
+
+        rk->setHistoricBestFit(best, e);
+        rk->setHistoricWorstFit(worst, e);
+        rk->setHistoricGBest(gBest, e);
+        rk->setHistoricMeanFit(sum / total, e);
+        rk->setHistoricVarFit(sumSq / total - (sum / total) * (sum / total), e);
+        rk->setTimeTaken(time, e);
+        rk->setFinalFuncCalls(calls, e);
+    }
+
+    // the final fitnesses of every island, one after another
+    int offset = 0;
+    for (int k = 0; k < count; ++k)
+    {
+        for (int i = 0; i < pops[k]->getPopSize(); ++i)
+            rk->setFinalFit(rks[k]->getFinalFit(i, 0), offset + i, 0);
+
+        offset += pops[k]->getPopSize();
+    }
+}
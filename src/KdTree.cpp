@@ -0,0 +1,202 @@
+/**
+ * @file KdTree.cpp
+ * @author Matthew Harker
+ * @brief A k-d tree for finding the nearest neighbours of a point
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <algorithm>
+
+#include "KdTree.h"
+
+using namespace std;
+
+// the most points a leaf holds
+static const int KD_LEAF = 8;
+
+/**
+ * @brief Construct a new Kd Tree:: Kd Tree object over a set of points
+ *
+ * @param newPoints The points, which must outlive the tree
+ * @param numPoints How many points there are
+ * @param numDims   The size of each point
+ */
+KdTree::KdTree(double* const* newPoints, const int numPoints, const int numDims)
+{
+    dims   = numDims;
+    count  = numPoints;
+    points = newPoints;
+
+    // a balanced tree never has more nodes than twice the next power of 2
+    int nodes = 1;
+    while (nodes < count)
+        nodes <<= 1;
+    nodes *= 2;
+
+    order      = new int[count];
+    splitDim   = new int[nodes];
+    splitValue = new double[nodes];
+
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+
+    if (count > 0)
+        build(0, 0, count);
+}
+
+/**
+ * @brief Destroy the Kd Tree:: Kd Tree object
+ *
+ */
+KdTree::~KdTree()
+{
+    delete [] order;
+    delete [] splitDim;
+    delete [] splitValue;
+}
+
+/**
+ * @brief Splits the points of a node at the median of their widest
+ *          dimension, then builds its children
+ *
+ * @param node  The index of the node
+ * @param from  The first of the node's points in order
+ * @param to    One past the last of the node's points in order
+ */
+void KdTree::build(const int node, const int from, const int to)
+{
+    if (to - from <= KD_LEAF)
+        return;
+
+    // find the dimension the points are most spread out in
+    int    widest = 0;
+    double spread = -1.0;
+
+    for (int d = 0; d < dims; ++d)
+    {
+        double low  = points[order[from]][d];
+        double high = low;
+
+        for (int i = from + 1; i < to; ++i)
+        {
+            double v = points[order[i]][d];
+            if (v < low)  low  = v;
+            if (v > high) high = v;
+        }
+
+        if (high - low > spread)
+        {
+            spread = high - low;
+            widest = d;
+        }
+    }
+
+    // put the median in the middle, smaller values before it
+    int mid = (from + to) / 2;
+    nth_element(order + from, order + mid, order + to, [&](int a, int b) {
+        return points[a][widest] < points[b][widest];
+    });
+
+    splitDim[node]   = widest;
+    splitValue[node] = points[order[mid]][widest];
+
+    build(2 * node + 1, from, mid);
+    build(2 * node + 2, mid, to);
+}
+
+/**
+ * @brief Looks for closer points under a node, visiting the side of
+ *          the split the query is on first and the other side only if
+ *          it could hold something closer than what was found
+ *
+ * @param node      The index of the node
+ * @param from      The first of the node's points in order
+ * @param to        One past the last of the node's points in order
+ * @param query     The point whose neighbours are wanted
+ * @param exclude   A point to skip (-1 for none)
+ * @param k         How many neighbours are wanted
+ * @param bestDist  The squared distances found so far, closest first
+ * @param bestId    The points found so far, closest first
+ * @param found     How many points have been found so far
+ */
+void KdTree::search(const int node, const int from, const int to, const double* query,
+                    const int exclude, const int k, double* bestDist, int* bestId, int& found)
+{
+    if (to - from <= KD_LEAF)
+    {
+        for (int i = from; i < to; ++i)
+        {
+            int id = order[i];
+            if (id == exclude)
+                continue;
+
+            double sq = 0;
+            for (int d = 0; d < dims; ++d)
+            {
+                double diff = points[id][d] - query[d];
+                sq += diff * diff;
+            }
+
+            // ties go to the lower id, so the result does not depend on the tree
+            if (found == k && (sq > bestDist[k-1] || (sq == bestDist[k-1] && id > bestId[k-1])))
+                continue;
+
+            // insert it in order, dropping the farthest if full
+            int at = (found < k) ? found++ : k - 1;
+            while (at > 0 && (bestDist[at-1] > sq || (bestDist[at-1] == sq && bestId[at-1] > id)))
+            {
+                bestDist[at] = bestDist[at-1];
+                bestId[at]   = bestId[at-1];
+                --at;
+            }
+
+            bestDist[at] = sq;
+            bestId[at]   = id;
+        }
+
+        return;
+    }
+
+    int    mid  = (from + to) / 2;
+    double diff = query[splitDim[node]] - splitValue[node];
+
+    if (diff < 0)
+    {
+        search(2 * node + 1, from, mid, query, exclude, k, bestDist, bestId, found);
+        if (found < k || diff * diff <= bestDist[k-1])
+            search(2 * node + 2, mid, to, query, exclude, k, bestDist, bestId, found);
+    }
+    else
+    {
+        search(2 * node + 2, mid, to, query, exclude, k, bestDist, bestId, found);
+        if (found < k || diff * diff <= bestDist[k-1])
+            search(2 * node + 1, from, mid, query, exclude, k, bestDist, bestId, found);
+    }
+}
+
+/**
+ * @brief Finds the nearest points to a query, closest first
+ *
+ * @param query         The point whose neighbours are wanted
+ * @param exclude       A point to skip, such as the query itself (-1 for none)
+ * @param k             How many neighbours are wanted
+ * @param neighbours    Where the ids of the neighbours are written
+ * @return int          How many neighbours were found (fewer than k if there are not enough points)
+ */
+int KdTree::nearest(const double* query, const int exclude, const int k, int* neighbours)
+{
+    if (k <= 0 || count == 0)
+        return 0;
+
+    double* bestDist = new double[k];
+    int     found    = 0;
+
+    search(0, 0, count, query, exclude, k, bestDist, neighbours, found);
+
+    delete [] bestDist;
+
+    return found;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file Neighbourhood.cpp
+ * @author Matthew Harker
+ * @brief The neighbourhoods of a particle swarm, and the best personal
+ *          best each particle can see
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <algorithm>
+#include <vector>
+
+#include "Neighbourhood.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Neighbourhood:: Neighbourhood object.
+ *          A ring links each particle to the ones beside it, von
+ *          Neumann to the four around it on a torus grid, and random
+ *          has each particle inform a number of others picked from
+ *          its own stream (step 1, past the velocity streams).
+ *
+ * @param topology      The shape of the neighbourhoods
+ * @param swarmSize     How many particles there are
+ * @param informants    How many others each particle informs (random only)
+ * @param rng           The random number generator of the run
+ */
+Neighbourhood::Neighbourhood(const int topology, const int swarmSize, const int informants, Random* rng)
+{
+    size = swarmSize;
+
+    vector<vector<int>> heard(size);
+
+    // a von Neumann grid is as square as the swarm allows
+    int rows = 1;
+    for (int r = 1; r * r <= size; ++r)
+        if (size % r == 0)
+            rows = r;
+
+    int cols = size / rows;
+
+    for (int i = 0; i < size; ++i)
+    {
+        heard[i].push_back(i);
+
+        if (topology == SWARM_RING)
+        {
+            heard[i].push_back((i + size - 1) % size);
+            heard[i].push_back((i + 1) % size);
+        }
+        else if (topology == SWARM_VON_NEUMANN)
+        {
+            int row = i / cols;
+            int col = i % cols;
+
+            heard[i].push_back(((row + rows - 1) % rows) * cols + col);
+            heard[i].push_back(((row + 1) % rows) * cols + col);
+            heard[i].push_back(row * cols + (col + cols - 1) % cols);
+            heard[i].push_back(row * cols + (col + 1) % cols);
+        }
+    }
+
+    // each particle informs its picks, so it is heard by them
+    if (topology == SWARM_RANDOM)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            rng->setStream(1, size + i);
+
+            for (int n = 0; n < informants; ++n)
+                heard[int(rng->uniform() * size)].push_back(i);
+        }
+    }
+
+    // store the informants of each particle, and from them the listeners
+    vector<vector<int>> told(size);
+
+    listenStart = new int[size + 1];
+    listenStart[0] = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        sort(heard[i].begin(), heard[i].end());
+        heard[i].erase(unique(heard[i].begin(), heard[i].end()), heard[i].end());
+
+        listenStart[i + 1] = listenStart[i] + heard[i].size();
+
+        for (size_t n = 0; n < heard[i].size(); ++n)
+            told[heard[i][n]].push_back(i);
+    }
+
+    listens     = new int[listenStart[size]];
+    informStart = new int[size + 1];
+    informs     = new int[listenStart[size]];
+    best        = new int[size];
+
+    informStart[0] = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        copy(heard[i].begin(), heard[i].end(), listens + listenStart[i]);
+
+        informStart[i + 1] = informStart[i] + told[i].size();
+        copy(told[i].begin(), told[i].end(), informs + informStart[i]);
+
+        best[i] = i;
+    }
+}
+
+/**
+ * @brief Destroy the Neighbourhood:: Neighbourhood object
+ *
+ */
+Neighbourhood::~Neighbourhood()
+{
+    delete [] listenStart;
+    delete [] listens;
+    delete [] informStart;
+    delete [] informs;
+    delete [] best;
+}
+
+/**
+ * @brief Finds the local best of every particle by scanning its
+ *          informants. Only needed once the personal bests are set up.
+ *
+ * @param pBestFit The personal best fitness of every particle
+ */
+void Neighbourhood::reset(const double* pBestFit)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        best[i] = listens[listenStart[i]];
+
+        for (int n = listenStart[i] + 1; n < listenStart[i + 1]; ++n)
+            if (pBestFit[listens[n]] < pBestFit[best[i]])
+                best[i] = listens[n];
+    }
+}
+
+/**
+ * @brief Updates the local bests after a particle's personal best
+ *          improved, checking only the particles it informs
+ *
+ * @param particle The particle whose personal best improved
+ * @param pBestFit The personal best fitness of every particle
+ */
+void Neighbourhood::improve(const int particle, const double* pBestFit)
+{
+    for (int n = informStart[particle]; n < informStart[particle + 1]; ++n)
+    {
+        int listener = informs[n];
+
+        if (pBestFit[particle] < pBestFit[best[listener]])
+            best[listener] = particle;
+    }
+}
+
+/**
+ * @brief Returns the particle with the best personal best that a
+ *          particle can see
+ *
+ * @param particle  The particle
+ * @return int      The index of its local best
+ */
+int Neighbourhood::getBest(const int particle)
+{
+    return best[particle];
+}
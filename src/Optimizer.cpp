@@ -0,0 +1,250 @@
+/**
+ * @file Optimizer.cpp
+ * @author Matthew Harker
+ * @brief An optimization run that can be stopped after any generation
+ *          and resumed later, and the tasks that take turns at them
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <cfloat>
+
+#include "Optimizer.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Optimizer:: Optimizer object that has not
+ *          started yet
+ *
+ * @param newPop    The population to optimize
+ * @param newRk     Records the optimization process
+ */
+Optimizer::Optimizer(Population* newPop, RecordKeeper* newRk)
+{
+    pop        = newPop;
+    rk         = newRk;
+    generation = 0;
+    started    = false;
+    stopped    = false;
+    bestSoFar  = DBL_MAX;
+    stale      = 0;
+}
+
+/**
+ * @brief Destroy the Optimizer:: Optimizer object
+ *
+ */
+Optimizer::~Optimizer()
+{
+}
+
+/**
+ * @brief Builds the starting population
+ *
+ */
+void Optimizer::start()
+{
+    initialize();
+    started = true;
+}
+
+/**
+ * @brief Runs the next generation
+ *
+ */
+void Optimizer::step()
+{
+    generate(generation);
+    ++generation;
+}
+
+/**
+ * @brief Returns the best fitness of the last generation
+ *
+ * @return double The best fitness
+ */
+double Optimizer::getBestFit()
+{
+    return rk->getHistoricBestFit(generation - 1);
+}
+
+/**
+ * @brief Returns the diversity of the population after the last
+ *          generation
+ *
+ * @return double The rms distance to the centroid, over the range width
+ */
+double Optimizer::getDiversity()
+{
+    return pop->getDiversity();
+}
+
+/**
+ * @brief Checks if the run has nothing left to gain from the
+ *          generations it has left: its best reached the function's
+ *          target, it went too long without improving, or the
+ *          solutions collapsed onto one point of the search space.
+ *          Only the last generation is looked at.
+ *
+ * @return true     The run should stop
+ * @return false    The run should carry on
+ */
+bool Optimizer::converged()
+{
+    double best = getBestFit();
+
+    // count the generations since the best last improved
+    if (best < bestSoFar)
+    {
+        bestSoFar = best;
+        stale     = 0;
+    }
+    else
+        ++stale;
+
+    if (best <= pop->getTarget())
+        return true;
+
+    if (pop->getPatience() > 0 && stale >= pop->getPatience())
+        return true;
+
+    return pop->getMinDiversity() > 0 && getDiversity() < pop->getMinDiversity();
+}
+
+/**
+ * @brief Records the final fitness of every solution. If the run
+ *          stopped early its last generation stands in for the rest.
+ *
+ */
+void Optimizer::finish()
+{
+    if (generation < pop->getExperimentations())
+        rk->holdRecords(generation);
+
+    for (int i = 0; i < pop->getPopSize(); ++i)
+        rk->setFinalFit(pop->getFitness(i), i, 0);
+}
+
+/**
+ * @brief Runs the next piece of the optimization: the starting
+ *          population on the first call, then one generation per
+ *          call until the last, or until the run converges. The
+ *          final results are recorded with the last one.
+ *
+ * @return true     There is more to run
+ * @return false    The optimization is done
+ */
+bool Optimizer::resume()
+{
+    if (!started)
+        start();
+    else
+    {
+        step();
+
+        if (converged())
+            stopped = true;
+    }
+
+    if (isDone())
+    {
+        finish();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the population being optimized
+ *
+ * @return Population* The population
+ */
+Population* Optimizer::getPopulation()
+{
+    return pop;
+}
+
+/**
+ * @brief Returns the records of the optimization
+ *
+ * @return RecordKeeper* The records
+ */
+RecordKeeper* Optimizer::getRecords()
+{
+    return rk;
+}
+
+/**
+ * @brief Returns how many generations have run
+ *
+ * @return int The number of generations
+ */
+int Optimizer::getGeneration()
+{
+    return generation;
+}
+
+/**
+ * @brief Checks if every generation has run, or the run stopped early
+ *
+ * @return true     The optimization is done
+ * @return false    There are generations left
+ */
+bool Optimizer::isDone()
+{
+    return started && (stopped || generation >= pop->getExperimentations());
+}
+
+/**
+ * @brief Runs an optimization from start to finish on the calling thread
+ *
+ * @param opt The optimization to run
+ */
+void runOptimizer(Optimizer* opt)
+{
+    while (opt->resume());
+}
+
+/**
+ * @brief Runs the optimization on the pool one piece per task. After
+ *          each generation the run goes back on the shared queue,
+ *          costed by the work it has left, so the threads take turns
+ *          at every run instead of each holding one until it is done.
+ *
+ * @param pool  The pool of threads to run on
+ * @param group The group the tasks are added to
+ * @param cost  The expected cost of the whole optimization
+ * @param done  What to do once the optimization is done
+ */
+void Optimizer::schedule(ThreadPool* pool, TaskGroup* group, double cost, function<void()> done)
+{
+    int    total = pop->getExperimentations();
+    double left  = (total > 0) ? cost * (total - generation) / total : cost;
+
+    pool->post(group, [=]{
+        if (resume())
+            Optimizer::schedule(pool, group, cost, done);
+        else
+            done();
+    }, left);
+}
+
+/**
+ * @brief Runs an optimization on the pool, in whatever pieces it
+ *          schedules itself in
+ *
+ * @param opt   The optimization to run
+ * @param pool  The pool of threads to run on
+ * @param group The group the tasks are added to
+ * @param cost  The expected cost of the whole optimization
+ * @param done  What to do once the optimization is done
+ */
+void scheduleOptimizer(Optimizer* opt, ThreadPool* pool, TaskGroup* group, double cost,
+                       function<void()> done)
+{
+    opt->schedule(pool, group, cost, done);
+}
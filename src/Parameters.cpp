@@ -23,14 +23,15 @@
 
 #include "functions.h"
 #include "Parameters.h"
+#include "Random.h"
 
 using namespace std;
 
 /**
  * @brief   Helper function for Parameters:: getParameters().
- *          Sets up the two float arrays to the proper size.
+ *          Sets up the two float arrays and the targets to the proper size.
  * 
- * @param numFuncs  The size of the two range arrays.
+ * @param numFuncs  The size of the range and target arrays.
  *                  The size is directly related to the number of
  *                  functions being used in the program.
  */
@@ -38,6 +39,7 @@ void Parameters::setupRanges(const int numFuncs)
 {
     lowRanges  = new float[numFuncs];
     highRanges = new float[numFuncs];
+    targets    = new double[numFuncs];
 }
 
 /**
@@ -103,6 +105,12 @@ Parameters getParameters()
                 params.highRanges[i] = M_PI;
             else
                 params.highRanges[i] = stof(range);
+
+            // an optional third value is the fitness to stop at
+            if (getline(ss, range, ','))
+                params.targets[i] = stod(range);
+            else
+                params.targets[i] = -INFINITY;
         }            
     }
     else
@@ -134,6 +142,24 @@ Parameters getParameters()
         file2 >> params.hmcr;
         file2 >> params.par;
 
+        file2 >> params.hsBatch;
+
+        file2 >> params.psoMode;
+        file2 >> params.psoSweeps;
+        file2 >> params.psoBudget;
+        file2 >> params.psoTopology;
+        file2 >> params.psoInformants;
+
+        file2 >> params.ffaNearest;
+
+        file2 >> params.patience;
+        file2 >> params.minDiversity;
+
+        file2 >> params.deScale;
+        file2 >> params.deCrossover;
+        file2 >> params.deStrategy;
+        file2 >> params.dePBest;
+
         // check variables to ensure they are within bounds
     }
     else
@@ -146,6 +172,68 @@ Parameters getParameters()
     // close the file
     file2.close();
 
+    // open the execution parameters file
+    ifstream file3 ("parameters/executionParams.txt");
+
+    if (file3.is_open())
+    {
+        // the master seed every generator of the run is derived from
+        file3 >> params.seed;
+
+        // a seed of 0 asks for a fresh one
+        if (params.seed == 0)
+            params.seed = generateMasterSeed();
+
+        // how the starting population is spread over the search space
+        file3 >> params.initMethod;
+
+        // how many worker threads to run the optimizations on
+        file3 >> params.numThreads;
+
+        // how many solutions one task of a population sweep handles
+        file3 >> params.chunkSize;
+
+        // how many independent runs each function gets
+        file3 >> params.replicates;
+
+        if (params.replicates < 1)
+            params.replicates = 1;
+
+        // how each population is split into islands, and how they migrate
+        file3 >> params.islands;
+        file3 >> params.migrationInterval;
+        file3 >> params.migrants;
+        file3 >> params.topology;
+
+        if (params.islands < 1)
+            params.islands = 1;
+        if (params.islands > MAX_ISLANDS)
+            params.islands = MAX_ISLANDS;
+
+        // every island needs at least two solutions of its own
+        if (params.islands > params.popSize / 2)
+            params.islands = params.popSize / 2 > 1 ? params.popSize / 2 : 1;
+
+        // how many worker processes the runs are sharded across
+        file3 >> params.processes;
+
+        // where the worker threads are pinned
+        file3 >> params.affinity;
+        file3 >> params.cpuList;
+
+        // whether the islands wait for each other every generation
+        file3 >> params.lockstep;
+    }
+    else
+    {
+        // if the file could not be found
+        cout << "Execution parameter file not found\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // close the file
+    file3.close();
+
     // return the params object
     return params;
 }
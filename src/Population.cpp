@@ -11,6 +11,7 @@
 #include <cfloat>
 #include <chrono>
 #include <climits>
+#include <cmath>
 #include <iostream>
 #include <random>
 
@@ -32,23 +33,45 @@ Population::Population(Parameters params, const int func)
     experimentations = params.experimentations;
     solutionSize     = params.numDims;
     numFuncs         = params.numFuncs;
+    seed             = params.seed;
+    initMethod       = params.initMethod;
+    chunkSize        = params.chunkSize;
+    island           = 0;
+    parameters       = params;
+    pool             = nullptr;
 
     dampener         = params.dampener;
     velConst1        = params.velConst1;
     velConst2        = params.velConst2;
+    updateMode       = params.psoMode;
+    sweeps           = params.psoSweeps;
+    evalBudget       = params.psoBudget;
+    swarmTopology    = params.psoTopology;
+    informants       = params.psoInformants;
 
     alpha            = params.alpha;
     beta             = params.beta;
     gamma            = params.gamma;
+    nearest          = params.ffaNearest;
 
     bandwidth        = params.bandwidth;
     hmcr             = params.hmcr;
     par              = params.par;
+    batchSize        = params.hsBatch;
+
+    scale            = params.deScale;
+    crossover        = params.deCrossover;
+    strategy         = params.deStrategy;
+    pBestRate        = params.dePBest;
+
+    target           = params.targets[func];
+    patience         = params.patience;
+    minDiversity     = params.minDiversity;
+    diversity        = 0.0;
 
     function         = func;
     funcCalls        = 0;
 
-    globBestFit = DBL_MAX;
 
     lowerBound = params.lowRanges[func];
     upperBound = params.highRanges[func];
@@ -56,8 +79,11 @@ Population::Population(Parameters params, const int func)
     // initialize fitness array
     fitness = new double[popSize];
 
-    // initialize the globalBest solution array and set the values to DBL_MAX
-    globBestVec = new double[solutionSize];
+    // initialize the shared global best, which starts at DBL_MAX
+    globBest = new GlobalBest(solutionSize);
+
+    // particles follow the global best until given a neighbourhood
+    neighbourhood = nullptr;
 
     // initialize the pBest fitness array
     pBestFit = new double[popSize];
@@ -75,6 +101,17 @@ Population::Population(Parameters params, const int func)
     for (int i = 0; i < popSize; ++i)
         population[i] = new double[solutionSize];
 
+    // every solution starts in its own buffer
+    slot      = new int[popSize];
+    slotOwner   = new int[popSize];
+    slotVersion = new int[popSize];
+    for (int i = 0; i < popSize; ++i)
+    {
+        slot[i]        = i;
+        slotOwner[i]   = i;
+        slotVersion[i] = 0;
+    }
+
     // initialize velocity matrix
     velocity = new double*[popSize];
     for (int i = 0; i < popSize; ++i)
@@ -97,13 +134,27 @@ Population::~Population()
         delete[] population;
     }
 
+    // destroy the slot array
+    if (slot != nullptr)
+        delete [] slot;
+
+    if (slotOwner != nullptr)
+        delete [] slotOwner;
+
+    if (slotVersion != nullptr)
+        delete [] slotVersion;
+
     // destroy the fitness array
     if (fitness != nullptr)
         delete [] fitness;
 
     // destroy the global best vector array
-    if (globBestVec != nullptr)
-        delete [] globBestVec;
+    if (globBest != nullptr)
+        delete globBest;
+
+    // destroy the neighbourhoods
+    if (neighbourhood != nullptr)
+        delete neighbourhood;
     
     // destroy the personal best fitness array
     if (pBestFit != nullptr)
@@ -171,6 +222,16 @@ void Population::incrimentFuncCalls()
     ++funcCalls;
 }
 
+/**
+ * @brief increase the number of function calls by a count
+ * 
+ * @param calls How many calls to add
+ */
+void Population::addFuncCalls(const int calls)
+{
+    funcCalls += calls;
+}
+
 void Population::resetFuncCalls()
 {
     funcCalls = 0;
@@ -206,6 +267,115 @@ int Population::getNumFuncs()
     return numFuncs;
 }
 
+/**
+ * @brief Returns the master seed the population's generators derive from
+ * 
+ * @return uint64_t master seed
+ */
+uint64_t Population::getSeed()
+{
+    return seed;
+}
+
+/**
+ * @brief Returns how the starting population is sampled
+ * 
+ * @return int initialization method (see InitMethod)
+ */
+int Population::getInitMethod()
+{
+    return initMethod;
+}
+
+/**
+ * @brief Returns how many solutions one task of a sweep handles
+ * 
+ * @return int chunk size (0 never splits a sweep)
+ */
+int Population::getChunkSize()
+{
+    return chunkSize;
+}
+
+/**
+ * @brief Returns which island the population is
+ * 
+ * @return int island (0 when the population is not split)
+ */
+int Population::getIsland()
+{
+    return island;
+}
+
+/**
+ * @brief Sets which island the population is. Each island draws
+ *          from its own random streams.
+ * 
+ * @param newIsland The island
+ */
+void Population::setIsland(const int newIsland)
+{
+    island = newIsland;
+}
+
+/**
+ * @brief Returns the parameters the population was built from
+ * 
+ * @return Parameters The parameters
+ */
+Parameters Population::getParameters()
+{
+    return parameters;
+}
+
+/**
+ * @brief Sets the pool that sweeps over the population are split across
+ * 
+ * @param newPool The pool (nullptr runs every sweep on the calling thread)
+ */
+void Population::setThreadPool(ThreadPool* newPool)
+{
+    pool = newPool;
+}
+
+/**
+ * @brief Returns the pool that sweeps over the population are split across
+ * 
+ * @return ThreadPool* The pool (nullptr if there is none)
+ */
+ThreadPool* Population::getThreadPool()
+{
+    return pool;
+}
+
+/**
+ * @brief Runs a sweep over the population in chunks of solutions.
+ *          The chunks run on the pool if there is one, otherwise the
+ *          whole sweep runs on the calling thread. The body must only
+ *          touch the solutions of its own chunk.
+ * 
+ * @param body The work to run on the solutions [from, to)
+ */
+void Population::forEachChunk(std::function<void(int, int)> body)
+{
+    forEachChunk(popSize, body);
+}
+
+/**
+ * @brief Runs a sweep over [0, count) in chunks, for work that is not
+ *          one item per solution (such as a batch of new solutions)
+ * 
+ * @param count How many items the sweep covers
+ * @param body  The work to run on the items [from, to)
+ */
+void Population::forEachChunk(const int count, std::function<void(int, int)> body)
+{
+    if (pool == nullptr)
+        body(0, count);
+    else
+        pool->parallelFor(0, count, chunkSize, body);
+}
+
 /**
  * @brief Returns the value of the dampener variable.
  *          Dampener affects the overall velocity of a particle's movement.
@@ -236,6 +406,57 @@ double Population::getVelConst2()
     return velConst2;
 }
 
+/**
+ * @brief Returns how PSO moves the swarm
+ * 
+ * @return int The update mode (synchronous or asynchronous)
+ */
+int Population::getUpdateMode()
+{
+    return updateMode;
+}
+
+/**
+ * @brief Returns how many times PSO moves the swarm per generation
+ * 
+ * @return int The sweeps per generation (the population size if unset)
+ */
+int Population::getSweeps()
+{
+    return (sweeps > 0) ? sweeps : popSize;
+}
+
+/**
+ * @brief Returns the most evaluations a PSO run may use
+ * 
+ * @return int The evaluation budget (0 for no limit)
+ */
+int Population::getEvalBudget()
+{
+    return evalBudget;
+}
+
+/**
+ * @brief Returns which neighbourhood each PSO particle follows
+ * 
+ * @return int The swarm topology
+ */
+int Population::getSwarmTopology()
+{
+    return swarmTopology;
+}
+
+/**
+ * @brief Returns how many others each particle informs in a
+ *          random topology
+ * 
+ * @return int The number of informants
+ */
+int Population::getInformants()
+{
+    return informants;
+}
+
 /**
  * @brief Returns the value of alpha
  * 
@@ -267,6 +488,17 @@ double Population::getGamma()
     return gamma;
 }
 
+/**
+ * @brief Returns how many of its nearest fireflies each firefly
+ *          compares itself with
+ * 
+ * @return int The number of neighbours (0 for every firefly)
+ */
+int Population::getNearest()
+{
+    return nearest;
+}
+
 /**
  * @brief Returns the value of bandwidth
  * 
@@ -301,6 +533,103 @@ double Population::getPAR()
     return par;
 }
 
+/**
+ * @brief Returns how many harmonies are improvised per iteration
+ * 
+ * @return int The size of a batch of harmonies
+ */
+int Population::getBatchSize()
+{
+    return batchSize;
+}
+
+/**
+ * @brief Returns the scale factor F of DE, how far a mutant follows
+ *          the difference between two solutions
+ * 
+ * @return double The scale factor
+ */
+double Population::getScale()
+{
+    return scale;
+}
+
+/**
+ * @brief Returns the crossover rate CR of DE, the chance an element
+ *          of a trial comes from the mutant
+ * 
+ * @return double The crossover rate
+ */
+double Population::getCrossover()
+{
+    return crossover;
+}
+
+/**
+ * @brief Returns how DE builds its mutants
+ * 
+ * @return int The strategy
+ */
+int Population::getStrategy()
+{
+    return strategy;
+}
+
+/**
+ * @brief Returns the share of the best solutions DE picks the pbest
+ *          of current-to-pbest from
+ * 
+ * @return double The share, in (0, 1]
+ */
+double Population::getPBestRate()
+{
+    return pBestRate;
+}
+
+/**
+ * @brief Returns the fitness of the function a run stops at once its
+ *          best solution reaches it
+ * 
+ * @return double The target (-inf if there is none)
+ */
+double Population::getTarget()
+{
+    return target;
+}
+
+/**
+ * @brief Returns how many generations in a row a run may go without
+ *          improving its best fitness before it stops
+ * 
+ * @return int The number of generations (0 never stops)
+ */
+int Population::getPatience()
+{
+    return patience;
+}
+
+/**
+ * @brief Returns the diversity a run stops below, once the
+ *          population has collapsed onto one point
+ * 
+ * @return double The diversity (0 never stops)
+ */
+double Population::getMinDiversity()
+{
+    return minDiversity;
+}
+
+/**
+ * @brief Returns the diversity found the last time the statistics
+ *          of the population were gathered
+ * 
+ * @return double The rms distance to the centroid, over the range width
+ */
+double Population::getDiversity()
+{
+    return diversity;
+}
+
 /**
  * @brief returns the value of the lowest allowable value
  * 
@@ -333,6 +662,124 @@ void Population::setPopulation(const int vec, double* newSol)
         population[vec][i] = newSol[i];
 }
 
+/**
+ * @brief Returns the buffer a solution lives in. The slot stays with
+ *          the buffer when insertSolution moves rows, so data kept per
+ *          slot (such as distances) does not have to be moved.
+ * 
+ * @param vec   The index of the solution
+ * @return int  The slot of the solution
+ */
+int Population::getSlot(const int vec)
+{
+    return slot[vec];
+}
+
+/**
+ * @brief Returns the solution that lives in a buffer
+ * 
+ * @param buffer    The slot
+ * @return int      The index of the solution in the slot
+ */
+int Population::getSlotOwner(const int buffer)
+{
+    return slotOwner[buffer];
+}
+
+/**
+ * @brief Returns how many times a buffer has been given a new solution
+ *          by insertSolution, so data kept per slot can tell when it
+ *          has gone stale
+ * 
+ * @param buffer    The slot
+ * @return int      The version of the slot
+ */
+int Population::getSlotVersion(const int buffer)
+{
+    return slotVersion[buffer];
+}
+
+/**
+ * @brief Inserts a solution at an index, shifting the worse solutions
+ *          back one position and dropping the last one. The rows are
+ *          moved by rotating their pointers, and the dropped buffer
+ *          (and its slot) is reused for the new solution.
+ * 
+ * @param vec       The index to insert the solution at
+ * @param newSol    The solution to insert
+ * @param newFit    The fitness of the solution
+ */
+void Population::insertSolution(const int vec, double* newSol, double newFit)
+{
+    double* lastRow  = population[popSize-1];
+    int     lastSlot = slot[popSize-1];
+
+    for (int i = popSize-1; i > vec; --i)
+    {
+        population[i] = population[i-1];
+        slot[i]       = slot[i-1];
+        fitness[i]    = fitness[i-1];
+
+        slotOwner[slot[i]] = i;
+    }
+
+    population[vec] = lastRow;
+    slot[vec]       = lastSlot;
+    fitness[vec]    = newFit;
+
+    slotOwner[lastSlot] = vec;
+    ++slotVersion[lastSlot];
+
+    for (int i = 0; i < solutionSize; ++i)
+        population[vec][i] = newSol[i];
+}
+
+/**
+ * @brief Inserts a solution into a population sorted from best to
+ *          worst, after every solution at least as good, dropping
+ *          the worst one
+ * 
+ * @param newSol    The solution to insert
+ * @param newFit    The fitness of the solution
+ * @return int      The index the solution was placed at
+ */
+int Population::insertSorted(double* newSol, double newFit)
+{
+    int index = 0;
+
+    // find the index to move it to, go from best to worst
+    while (index < popSize-1 && newFit >= fitness[index])
+        ++index;
+
+    insertSolution(index, newSol, newFit);
+
+    return index;
+}
+
+/**
+ * @brief Puts a solution in place of the worst one of an unsorted
+ *          population, if it is better
+ * 
+ * @param newSol    The solution
+ * @param newFit    The fitness of the solution
+ * @return int      The index it replaced (-1 if it was not better)
+ */
+int Population::replaceWorst(double* newSol, double newFit)
+{
+    int worst = 0;
+    for (int i = 1; i < popSize; ++i)
+        if (fitness[i] > fitness[worst])
+            worst = i;
+
+    if (newFit >= fitness[worst])
+        return -1;
+
+    setPopulation(worst, newSol);
+    fitness[worst] = newFit;
+
+    return worst;
+}
+
 /**
  * @brief Set the value of an element in the population matrix
  * 
@@ -392,6 +839,17 @@ double Population::getPBestVec(const int vec, const int elem)
     return pBestVec[vec][elem];
 }
 
+/**
+ * @brief Returns a vector of the pBestVec matrix
+ * 
+ * @param vec       The vector to return
+ * @return double*  The personal best solution of the vector
+ */
+double* Population::getPBestVec(const int vec)
+{
+    return pBestVec[vec];
+}
+
 /**
  * @brief Sets a value in the pBestFit array
  * 
@@ -415,14 +873,40 @@ double Population::getPBestFit(const int vec)
 }
 
 /**
- * @brief Sets a value in the globBestVec array
+ * @brief Returns the full pBestFit array
+ * 
+ * @return double* The personal best fitness of every solution
+ */
+double* Population::getPBestFit()
+{
+    return pBestFit;
+}
+
+/**
+ * @brief Offers a solution as the global best. Any thread may call
+ *          this at any time; see GlobalBest::offer
  * 
- * @param elem      The element of the array to set
- * @param newBest   The value to set the element to
+ * @param newSol    The solution
+ * @param newFit    The fitness of the solution
+ * @param round     The round (such as the generation) of the offer
+ * @param index     The index of the solution within the round
+ * @return true     The solution is the new global best
+ * @return false    The global best was at least as good
  */
-void Population::setGlobalBestVec(const int elem, double newBest)
+bool Population::offerGlobalBest(const double* newSol, double newFit, const int round, const int index)
 {
-    globBestVec[elem] = newBest;
+    return globBest->offer(newSol, newFit, round, index);
+}
+
+/**
+ * @brief Copies the global best vector as one consistent snapshot
+ * 
+ * @param out       Where the vector is copied to
+ * @return double   The fitness of the copied vector
+ */
+double Population::readGlobalBest(double* out)
+{
+    return globBest->read(out);
 }
 
 /**
@@ -433,27 +917,41 @@ void Population::setGlobalBestVec(const int elem, double newBest)
  */
 double Population::getGlobalBestVec(const int elem)
 {
-    return globBestVec[elem];
+    return globBest->getElement(elem);
 }
 
 /**
- * @brief Sets the value of globBestFit
+ * @brief Returns the value of globBestFit
  * 
- * @param newFit The new value for globBestFit
+ * @return double The value of globBestFit
  */
-void Population::setGlobalBestFit(double newFit)
+double Population::getGlobalBestFit()
 {
-    globBestFit = newFit;
+    return globBest->getFitness();
 }
 
 /**
- * @brief Returns the value of globBestFit
+ * @brief Gives the particles neighbourhoods to follow, replacing any
+ *          they had. The population takes ownership of them.
  * 
- * @return double The value of globBestFit
+ * @param newNeighbourhood The neighbourhoods (nullptr for the global best)
  */
-double Population::getGlobalBestFit()
+void Population::setNeighbourhood(Neighbourhood* newNeighbourhood)
 {
-    return globBestFit;
+    if (neighbourhood != nullptr)
+        delete neighbourhood;
+
+    neighbourhood = newNeighbourhood;
+}
+
+/**
+ * @brief Returns the neighbourhoods the particles follow
+ * 
+ * @return Neighbourhood* The neighbourhoods (nullptr for the global best)
+ */
+Neighbourhood* Population::getNeighbourhood()
+{
+    return neighbourhood;
 }
 
 /**
@@ -482,14 +980,86 @@ int Population::getIndexOfBest()
 }
 
 /**
- * @brief Generates the fitness of every solution vector
+ * @brief Gathers the best, worst, mean, and variance of the fitness
+ *          array in a single pass, for both the algorithms and their
+ *          records, along with the diversity of the solutions: their
+ *          rms distance to the centroid over the width of the range.
+ *          Both are accumulated around the first solution so the sums
+ *          of squares stay well conditioned. The diversity is also
+ *          kept for the stopping test.
+ * 
+ * @return PopulationStats  The statistics of the population
+ */
+PopulationStats Population::getStats()
+{
+    PopulationStats stats;
+    stats.bestIndex   = 0;
+    stats.worstIndex  = 0;
+
+    double best  = fitness[0];
+    double worst = fitness[0];
+    double shift = fitness[0];
+    double sum   = 0.0;
+    double sumSq = 0.0;
+
+    // the sum of each element, and the sum of squares over every element
+    double* posSum   = new double[solutionSize]();
+    double  posSumSq = 0.0;
+
+    for (int i = 0; i < popSize; ++i)
+    {
+        double fit = fitness[i];
+        double dev = fit - shift;
+
+        sum   += dev;
+        sumSq += dev * dev;
+
+        // keep the first occurence of the best and worst
+        if (fit < best)  { best  = fit; stats.bestIndex  = i; }
+        if (fit > worst) { worst = fit; stats.worstIndex = i; }
+
+        for (int j = 0; j < solutionSize; ++j)
+        {
+            double off = population[i][j] - population[0][j];
+
+            posSum[j] += off;
+            posSumSq  += off * off;
+        }
+    }
+
+    stats.mean     = shift + sum / popSize;
+    stats.variance = (sumSq - sum * sum / popSize) / popSize;
+
+    // the squared distances to the centroid, summed over the solutions
+    double spread = posSumSq;
+    for (int j = 0; j < solutionSize; ++j)
+        spread -= posSum[j] * posSum[j] / popSize;
+
+    delete [] posSum;
+
+    double width = upperBound - lowerBound;
+
+    stats.diversity = (spread > 0.0 && width > 0.0) ? sqrt(spread / popSize) / width : 0.0;
+    diversity       = stats.diversity;
+
+    return stats;
+}
+
+/**
+ * @brief Generates the fitness of every solution vector.
+ *          The population is evaluated in chunks across the pool.
  * 
  */
 void Population::generateAllFitness()
 {
     // calculate the fitness for every solution
-    for (int i = 0; i < popSize; ++i)
-        generateOneFitness(i);
+    forEachChunk([this](int from, int to) {
+        for (int i = from; i < to; ++i)
+            fitness[i] = runSolution(population[i], solutionSize, function);
+    });
+
+    // count the calls once the chunks are done
+    funcCalls += popSize;
 }
 
 /**
@@ -562,6 +1132,17 @@ double Population::getVelocity(const int vec, const int elem)
     return velocity[vec][elem];
 }
 
+/**
+ * @brief Returns a vector of the velocity matrix
+ * 
+ * @param vec       The vector to return
+ * @return double*  The velocity of the vector
+ */
+double* Population::getVelocity(const int vec)
+{
+    return velocity[vec];
+}
+
 
 /**
  * @brief A method of insertion sort which will sort the
@@ -582,21 +1163,24 @@ void Population::sortPopulation()
     // for every solution in the matrix
     for (int i = 1; i < popSize; ++i)
     {
-        // get the fitness to sort
+        // get the fitness and solution to sort
         curFit = fitness[i];
 
+        for (int x = 0; x < solutionSize; ++x)
+            curSol[x] = population[i][x];
+
         // get the initial index to compare
         int j = i - 1;
 
         // for the remainder of the unsorted array
-        while (j >= 0 && fitness[j] > curFit)   /* double check the right comparator */
+        while (j >= 0 && fitness[j] > curFit)
         {
             // move the compared fitness forward one
             fitness[j+1] = fitness[j];
 
             // move the corresponding solution vector forward one position
             for (int x = 0; x < solutionSize; ++x)
-                curSol[x] = population[j][x];
+                population[j+1][x] = population[j][x];
             
             // move the index backwards
             --j;
@@ -0,0 +1,154 @@
+/**
+ * @file Random.cpp
+ * @author Matthew Harker
+ * @brief Fast pseudo random number generation for the optimizers
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <cmath>
+#include <random>
+
+#include "Random.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Random:: Random object.
+ *          The stream starts at step 0, member 0.
+ *
+ * @param seed      The master seed of the program run
+ * @param algorithm The optimizer the generator is used by
+ * @param function  The function the optimizer is running
+ * @param island    The island of the population (0 without islands)
+ */
+Random::Random(uint64_t seed, const int algorithm, const int function, const int island)
+{
+    key[0] = uint32_t(seed);
+    key[1] = uint32_t(seed >> 32);
+
+    counter[3] = (uint32_t(island) << 24) | (uint32_t(algorithm) << 16) | uint32_t(function);
+
+    setStream(0, 0);
+}
+
+/**
+ * @brief Moves the generator to the start of another stream.
+ *          A step is one stage of a run (initialization, a
+ *          generation, an improvisation) and a member is the
+ *          solution vector the numbers are drawn for.
+ *
+ * @param step      The stage of the run
+ * @param member    The solution vector within the stage
+ */
+void Random::setStream(const int step, const int member)
+{
+    counter[0] = 0;
+    counter[1] = uint32_t(member);
+    counter[2] = uint32_t(step);
+    used       = 4;
+}
+
+/**
+ * @brief Fills a buffer with uniform doubles in (0, 1].
+ *          Zero is excluded so callers need no rejection loop
+ *          and the values can be passed straight to log().
+ *          Every block is computed from its own counter, so
+ *          there is no dependency between iterations.
+ *
+ * @param buffer    The array to fill
+ * @param n         How many values to write
+ */
+void Random::fillUniform(double* buffer, const int n)
+{
+    const double scale = 1.0 / 9007199254740992.0;
+    int blocks = (n + 1) / 2;
+
+    for (int b = 0; b < blocks; ++b)
+    {
+        uint32_t ctr[4] = { counter[0] + uint32_t(b), counter[1], counter[2], counter[3] };
+        uint32_t out[4];
+        philox(ctr, key, out);
+
+        uint64_t bits0 = (uint64_t(out[0]) << 32) | out[1];
+        uint64_t bits1 = (uint64_t(out[2]) << 32) | out[3];
+
+        buffer[2*b] = ((bits0 >> 11) + 1) * scale;
+        if (2*b + 1 < n)
+            buffer[2*b + 1] = ((bits1 >> 11) + 1) * scale;
+    }
+
+    // continue the stream after the blocks that were used
+    counter[0] += uint32_t(blocks);
+    used        = 4;
+}
+
+/**
+ * @brief Fills a buffer with standard normal doubles.
+ *          Uniform pairs are drawn in bulk then turned into normal
+ *          pairs in place with the Box-Muller transform.
+ *
+ * @param buffer    The array to fill
+ * @param n         How many values to write
+ */
+void Random::fillNormal(double* buffer, const int n)
+{
+    const double twoPi = 2.0 * M_PI;
+    int pairs = n / 2;
+
+    fillUniform(buffer, 2 * pairs);
+
+    for (int i = 0; i < pairs; ++i)
+    {
+        double radius = sqrt(-2.0 * log(buffer[2*i]));
+        double theta  = twoPi * buffer[2*i + 1];
+
+        buffer[2*i]     = radius * cos(theta);
+        buffer[2*i + 1] = radius * sin(theta);
+    }
+
+    // an odd count needs one more pair, half of which is dropped
+    if (n % 2 == 1)
+    {
+        double extra[2];
+        fillUniform(extra, 2);
+        buffer[n-1] = sqrt(-2.0 * log(extra[0])) * cos(twoPi * extra[1]);
+    }
+}
+
+/**
+ * @brief Creates a master seed from the hardware entropy source.
+ *          This should be the only place random_device is used.
+ *
+ * @return uint64_t The master seed
+ */
+uint64_t generateMasterSeed()
+{
+    random_device rd;
+
+    return (uint64_t(rd()) << 32) | rd();
+}
+
+/**
+ * @brief Derives the seed of a replicate from the master seed.
+ *          Replicate 0 uses the master seed itself, so a single
+ *          replicate reproduces a run without replicates.
+ *
+ * @param seed      The master seed of the program run
+ * @param replicate The index of the replicate
+ * @return uint64_t The seed of the replicate
+ */
+uint64_t replicateSeed(uint64_t seed, const int replicate)
+{
+    if (replicate == 0)
+        return seed;
+
+    // splitmix64 of the master seed, offset by the replicate
+    uint64_t z = seed + uint64_t(replicate) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
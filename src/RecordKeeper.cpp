@@ -27,21 +27,25 @@ RecordKeeper::RecordKeeper(Parameters param)
     solutionSize     = param.numDims;
 
     // setup historicGBest
-    historicGBest = new double[experimentations];
+    historicGBest = new double[experimentations]();
 
     // setup historicPBest
     historicPBest = new double*[populationSize];
     for (int i = 0; i < populationSize; ++i)
-        historicPBest[i] = new double[experimentations];
+        historicPBest[i] = new double[experimentations]();
 
     // setup historicBestFit and historicWorstFit
     historicBestFit  = new double[experimentations];
     historicWorstFit = new double[experimentations];
 
+    // setup historicMeanFit and historicVarFit
+    historicMeanFit = new double[experimentations]();
+    historicVarFit  = new double[experimentations]();
+
     // setup historicFit
     historicFit = new double*[populationSize];
     for (int i = 0; i < populationSize; ++i)
-        historicFit[i] = new double[experimentations];
+        historicFit[i] = new double[experimentations]();
 
     // setup finalFit
     finalFit = new double*[populationSize];
@@ -81,6 +85,14 @@ RecordKeeper::~RecordKeeper()
     if (historicWorstFit != nullptr)
         delete[] historicWorstFit;
 
+    // destroy historicMeanFit
+    if (historicMeanFit != nullptr)
+        delete[] historicMeanFit;
+
+    // destroy historicVarFit
+    if (historicVarFit != nullptr)
+        delete[] historicVarFit;
+
     // destroy historicFits
     if (historicFit != nullptr)
     {
@@ -159,6 +171,18 @@ void RecordKeeper::setHistoricPBest(double newBest, const int vec, const int ele
     historicPBest[vec][elem] = newBest;
 }
 
+/**
+ * @brief Sets one experiment of the historicPBest matrix for every particle
+ * 
+ * @param newBest   The array of pBest values (one per particle)
+ * @param elem      The experiment being written to
+ */
+void RecordKeeper::setHistoricPBest(double* newBest, const int elem)
+{
+    for (int i = 0; i < populationSize; ++i)
+        historicPBest[i][elem] = newBest[i];
+}
+
 /**
  * @brief Returns the value of an element in the historicPBest matrix
  * 
@@ -276,6 +300,50 @@ double RecordKeeper::getHistoricWorstFit(const int elem)
     return historicWorstFit[elem];
 }
 
+/**
+ * @brief Sets the value of an element in the historicMeanFit array
+ * 
+ * @param newMean   The new value to set the element to
+ * @param elem      The element whose value is being changed
+ */
+void RecordKeeper::setHistoricMeanFit(double newMean, const int elem)
+{
+    historicMeanFit[elem] = newMean;
+}
+
+/**
+ * @brief Sets the value of an element in the historicVarFit array
+ * 
+ * @param newVar    The new value to set the element to
+ * @param elem      The element whose value is being changed
+ */
+void RecordKeeper::setHistoricVarFit(double newVar, const int elem)
+{
+    historicVarFit[elem] = newVar;
+}
+
+/**
+ * @brief Returns a value from an element in the historicMeanFit array
+ * 
+ * @param elem      The element whose value is being returned
+ * @return double   The value of the specified element
+ */
+double RecordKeeper::getHistoricMeanFit(const int elem)
+{
+    return historicMeanFit[elem];
+}
+
+/**
+ * @brief Returns a value from an element in the historicVarFit array
+ * 
+ * @param elem      The element whose value is being returned
+ * @return double   The value of the specified element
+ */
+double RecordKeeper::getHistoricVarFit(const int elem)
+{
+    return historicVarFit[elem];
+}
+
 /**
  * @brief Sets an element of the finalFit matrix
  * 
@@ -346,7 +414,105 @@ double RecordKeeper::getTimeTaken(const int expr)
     return timeTaken[expr];
 }
 
+/**
+ * @brief Fills the experiments of a run that stopped early with its
+ *          last experiment, taking no time and no function calls, so
+ *          every run has the same number of experiments
+ * 
+ * @param from The first experiment that did not run
+ */
+void RecordKeeper::holdRecords(const int from)
+{
+    if (from < 1)
+        return;
+
+    for (int e = from; e < experimentations; ++e)
+    {
+        historicGBest[e]    = historicGBest[e-1];
+        historicBestFit[e]  = historicBestFit[e-1];
+        historicWorstFit[e] = historicWorstFit[e-1];
+        historicMeanFit[e]  = historicMeanFit[e-1];
+        historicVarFit[e]   = historicVarFit[e-1];
 
+        for (int i = 0; i < populationSize; ++i)
+        {
+            historicPBest[i][e] = historicPBest[i][e-1];
+            historicFit[i][e]   = historicFit[i][e-1];
+        }
 
+        timeTaken[e]      = 0.0;
+        finalFuncCalls[e] = 0;
+    }
+}
 
+/**
+ * @brief Returns how many doubles pack() writes
+ * 
+ * @return int The size of the packed records
+ */
+int RecordKeeper::getPackedSize()
+{
+    return experimentations * (7 + 2 * populationSize) + populationSize;
+}
 
+/**
+ * @brief Writes every record into one flat buffer, so it can be sent
+ *          to another process. Only the first experiment of finalFit
+ *          is written, as it is the only one the optimizers fill.
+ * 
+ * @param buffer The buffer to write to (getPackedSize() doubles)
+ */
+void RecordKeeper::pack(double* buffer)
+{
+    for (int e = 0; e < experimentations; ++e)
+    {
+        *buffer++ = historicGBest[e];
+        *buffer++ = historicBestFit[e];
+        *buffer++ = historicWorstFit[e];
+        *buffer++ = historicMeanFit[e];
+        *buffer++ = historicVarFit[e];
+        *buffer++ = finalFuncCalls[e];
+        *buffer++ = timeTaken[e];
+    }
+
+    for (int i = 0; i < populationSize; ++i)
+    {
+        for (int e = 0; e < experimentations; ++e)
+        {
+            *buffer++ = historicPBest[i][e];
+            *buffer++ = historicFit[i][e];
+        }
+
+        *buffer++ = finalFit[i][0];
+    }
+}
+
+/**
+ * @brief Reads every record back from a buffer written by pack()
+ * 
+ * @param buffer The buffer to read from
+ */
+void RecordKeeper::unpack(const double* buffer)
+{
+    for (int e = 0; e < experimentations; ++e)
+    {
+        historicGBest[e]    = *buffer++;
+        historicBestFit[e]  = *buffer++;
+        historicWorstFit[e] = *buffer++;
+        historicMeanFit[e]  = *buffer++;
+        historicVarFit[e]   = *buffer++;
+        finalFuncCalls[e]   = int(*buffer++);
+        timeTaken[e]        = *buffer++;
+    }
+
+    for (int i = 0; i < populationSize; ++i)
+    {
+        for (int e = 0; e < experimentations; ++e)
+        {
+            historicPBest[i][e] = *buffer++;
+            historicFit[i][e]   = *buffer++;
+        }
+
+        finalFit[i][0] = *buffer++;
+    }
+}
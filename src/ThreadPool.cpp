@@ -0,0 +1,326 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Matthew Harker
+ * @brief A work stealing pool of threads that the optimizers share
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include "ThreadPool.h"
+
+using namespace std;
+
+// the pool and worker index of the calling thread (-1 outside any pool)
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local int         currentIndex = -1;
+
+/**
+ * @brief Construct a new Thread Pool:: Thread Pool object
+ *
+ * @param threads How many workers to start (0 uses every hardware thread)
+ */
+ThreadPool::ThreadPool(const int threads)
+{
+    numThreads = threads;
+
+    if (numThreads <= 0)
+        numThreads = thread::hardware_concurrency();
+    if (numThreads <= 0)
+        numThreads = 1;
+
+    pending  = 0;
+    spawned  = 0;
+    stopping = false;
+
+    workers = new Worker[numThreads];
+
+    this->threads = new thread[numThreads];
+    for (int i = 0; i < numThreads; ++i)
+        this->threads[i] = thread(&ThreadPool::workerLoop, this, i);
+}
+
+/**
+ * @brief Destroy the Thread Pool:: Thread Pool object.
+ *          Workers finish every queued task before they exit.
+ *
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (int i = 0; i < numThreads; ++i)
+        threads[i].join();
+
+    delete [] threads;
+    delete [] workers;
+}
+
+/**
+ * @brief Returns the number of worker threads
+ *
+ * @return int number of worker threads
+ */
+int ThreadPool::getNumThreads()
+{
+    return numThreads;
+}
+
+/**
+ * @brief Returns the index of the calling worker
+ *
+ * @return int The index, or -1 if the caller is not a worker of this pool
+ */
+int ThreadPool::getWorkerIndex()
+{
+    return (currentPool == this) ? currentIndex : -1;
+}
+
+/**
+ * @brief Returns the native handle of a worker, so it can be pinned
+ *
+ * @param worker The index of the worker
+ * @return std::thread::native_handle_type The handle of its thread
+ */
+thread::native_handle_type ThreadPool::getNativeHandle(const int worker)
+{
+    return threads[worker].native_handle();
+}
+
+/**
+ * @brief Queues a task.
+ *          Workers keep their own tasks so nested work stays on the
+ *          thread (and cache) that created it. Everything else is
+ *          shared and ordered by cost.
+ *
+ * @param group The group the task belongs to
+ * @param work  The work to run
+ * @param cost  An estimate of how expensive the task is
+ */
+void ThreadPool::submit(TaskGroup* group, function<void()> work, double cost)
+{
+    enqueue(group, work, cost, getWorkerIndex());
+}
+
+/**
+ * @brief Queues a task on the shared queue, even from a worker. A
+ *          task that requeues itself this way waits its turn behind
+ *          the other shared tasks instead of running next on the
+ *          same worker.
+ *
+ * @param group The group the task belongs to
+ * @param work  The work to run
+ * @param cost  An estimate of how expensive the task is
+ */
+void ThreadPool::post(TaskGroup* group, function<void()> work, double cost)
+{
+    enqueue(group, work, cost, -1);
+}
+
+/**
+ * @brief Queues a task on a worker's deque, or on the shared queue
+ *
+ * @param group The group the task belongs to
+ * @param work  The work to run
+ * @param cost  An estimate of how expensive the task is
+ * @param self  The worker whose deque gets the task (-1 for the shared queue)
+ */
+void ThreadPool::enqueue(TaskGroup* group, function<void()> work, double cost, const int self)
+{
+    Task task;
+    task.work  = work;
+    task.group = group;
+    task.cost  = cost;
+
+    ++group->remaining;
+
+    if (self >= 0)
+    {
+        lock_guard<mutex> guard(workers[self].lock);
+        workers[self].tasks.push_back(task);
+        ++spawned;
+    }
+    else
+    {
+        lock_guard<mutex> guard(sharedLock);
+        shared.push(task);
+    }
+
+    ++pending;
+
+    // take the lock so a worker about to sleep cannot miss the task
+    {
+        lock_guard<mutex> guard(sleepLock);
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Runs tasks until every task of a group has finished.
+ *          A worker only helps with tasks spawned by other workers,
+ *          so waiting on a few small chunks never picks up a whole
+ *          optimization run from the shared queue.
+ *
+ * @param group The group to wait on
+ */
+void ThreadPool::wait(TaskGroup* group)
+{
+    int  self        = getWorkerIndex();
+    bool allowShared = (self < 0);
+    Task task;
+
+    while (group->remaining > 0)
+    {
+        if (takeTask(self, task, allowShared))
+        {
+            runTask(task);
+            continue;
+        }
+
+        // nothing to help with, so sleep until something changes
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [&]{
+            return group->remaining == 0 || (allowShared ? pending > 0 : spawned > 0);
+        });
+    }
+}
+
+/**
+ * @brief Splits a range into chunks and runs them on the pool.
+ *          The calling thread waits (and helps) until every chunk is
+ *          done. Small ranges are run directly on the calling thread.
+ *
+ * @param begin The first index of the range
+ * @param end   One past the last index of the range
+ * @param chunk The largest number of indices in one task (0 never splits)
+ * @param body  The work to run on the indices [from, to)
+ */
+void ThreadPool::parallelFor(const int begin, const int end, const int chunk,
+                             function<void(int, int)> body)
+{
+    if (chunk <= 0 || end - begin <= chunk)
+    {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group;
+
+    for (int from = begin; from < end; from += chunk)
+    {
+        int to = (from + chunk < end) ? from + chunk : end;
+        submit(&group, [=]{ body(from, to); }, to - from);
+    }
+
+    wait(&group);
+}
+
+/**
+ * @brief Takes the next task for a thread, in order: the newest task of
+ *          its own deque, the most expensive shared task, then the
+ *          oldest task of another worker.
+ *
+ * @param self          The index of the worker (-1 for outside threads)
+ * @param task          The task that was taken
+ * @param allowShared   Whether tasks from the shared queue may be taken
+ * @return true         A task was taken
+ * @return false        There was nothing to take
+ */
+bool ThreadPool::takeTask(const int self, Task& task, const bool allowShared)
+{
+    if (pending == 0)
+        return false;
+
+    if (self >= 0)
+    {
+        lock_guard<mutex> guard(workers[self].lock);
+        if (!workers[self].tasks.empty())
+        {
+            task = workers[self].tasks.back();
+            workers[self].tasks.pop_back();
+            --spawned;
+            --pending;
+            return true;
+        }
+    }
+
+    if (allowShared)
+    {
+        lock_guard<mutex> guard(sharedLock);
+        if (!shared.empty())
+        {
+            task = shared.top();
+            shared.pop();
+            --pending;
+            return true;
+        }
+    }
+
+    for (int i = 1; i <= numThreads; ++i)
+    {
+        int victim = (self + i + numThreads) % numThreads;
+        if (victim == self)
+            continue;
+
+        lock_guard<mutex> guard(workers[victim].lock);
+        if (!workers[victim].tasks.empty())
+        {
+            task = workers[victim].tasks.front();
+            workers[victim].tasks.pop_front();
+            --spawned;
+            --pending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Runs a task and wakes any waiters once its group is done
+ *
+ * @param task The task to run
+ */
+void ThreadPool::runTask(Task& task)
+{
+    task.work();
+
+    if (--task.group->remaining == 0)
+    {
+        lock_guard<mutex> guard(sleepLock);
+        wake.notify_all();
+    }
+}
+
+/**
+ * @brief The loop each worker thread runs until the pool is destroyed
+ *
+ * @param index The index of the worker
+ */
+void ThreadPool::workerLoop(const int index)
+{
+    currentPool  = this;
+    currentIndex = index;
+
+    Task task;
+
+    while (true)
+    {
+        if (takeTask(index, task, true))
+        {
+            runTask(task);
+            continue;
+        }
+
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [&]{ return stopping || pending > 0; });
+
+        if (stopping && pending == 0)
+            return;
+    }
+}
@@ -19,6 +19,78 @@
 
 using namespace std;
 
+/**
+ * @brief Creates a CSV file holding the master seed of the run.
+ *          Putting the seed back into executionParams.txt
+ *          reproduces every result of the run.
+ * 
+ * @param seed The master seed of the run
+ */
+void seedCSV(uint64_t seed)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/seed.csv";
+
+    // create or open the csv, then write the seed
+    ofstream csv(pathName);
+    csv << seed << '\n';
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates the CSV files summarizing the replicates of an algorithm:
+ *          the mean, median, and quartile convergence curves
+ * 
+ * @param curves    The merged replicates of each function
+ * @param numFuncs  How many functions there are
+ * @param prefix    The path and file prefix, such as results/PSO/replicates/pso
+ */
+void replicateCSVs(Convergence** curves, const int numFuncs, string prefix)
+{
+    convergenceCSV(curves, numFuncs, prefix + "RepMean.csv", -1.0);
+    convergenceCSV(curves, numFuncs, prefix + "RepMedian.csv", 0.5);
+    convergenceCSV(curves, numFuncs, prefix + "RepQ1.csv", 0.25);
+    convergenceCSV(curves, numFuncs, prefix + "RepQ3.csv", 0.75);
+}
+
+/**
+ * @brief Creates a CSV file holding one convergence curve per function
+ * 
+ * @param curves    The merged replicates of each function
+ * @param numFuncs  How many functions there are
+ * @param pathName  The filename (and path) of the csv
+ * @param q         The quantile to write (below 0 writes the mean)
+ */
+void convergenceCSV(Convergence** curves, const int numFuncs, string pathName, double q)
+{
+    // create or open the csv
+    ofstream csv(pathName);
+
+    // for each function, write the curve
+    for (int i = 0; i < numFuncs; ++i)
+    {
+        for (int j = 0; j < curves[i]->getExperimentations(); ++j)
+        {
+            // separate every value after the first
+            if (j > 0)
+                csv << ",";
+
+            if (q < 0)
+                csv << curves[i]->getMean(j);
+            else
+                csv << curves[i]->getQuantile(j, q);
+        }
+
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
 /**
  * @brief Creates every CSV file for PSO
  * 
@@ -31,6 +103,8 @@ void particleCSVs(RecordKeeper** rks)
     // create a csv for each function
     particleGBestFit(rks);
     particleWorstFit(rks);
+    particleMeanFit(rks);
+    particleVarFit(rks);
     particleFinalFits(rks);
     particleFuncCalls(rks);
     particleTimeTaken(rks);
@@ -101,6 +175,68 @@ void particleWorstFit(RecordKeeper** rks)
     csv.close();
 }
 
+/**
+ * @brief Creates a CSV file for PSO containing info on meanFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void particleMeanFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/PSO/histMeanFit/psoMeanFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the meanFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricMeanFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricMeanFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for PSO containing info on varFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void particleVarFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/PSO/histVarFit/psoVarFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the varFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricVarFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricVarFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
 /**
  * @brief Creates a CSV file for PSO containing info on finalFits
  * 
@@ -543,3 +679,241 @@ void harmonyTimeTaken(RecordKeeper** rks)
     // close the csv file
     csv.close();
 }
+
+/**
+ * @brief Creates every CSV file for DE
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialCSVs(RecordKeeper** rks)
+{
+    cout << "creating Differential Evolution CSV files\n";
+
+    // create the CSVs
+    differentialHistBestFit(rks);
+    differentialHistWorstFit(rks);
+    differentialMeanFit(rks);
+    differentialVarFit(rks);
+    differentialFinalFits(rks);
+    differentialFuncCalls(rks);
+    differentialTimeTaken(rks);
+
+    cout << "csv files have been created for Differential Evolution\n";
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on bestFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialHistBestFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/histBestFit/deBestFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the bestFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricBestFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricBestFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on worstFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialHistWorstFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/histWorstFit/deWorstFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the worstFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricWorstFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricWorstFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on meanFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialMeanFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/histMeanFit/deMeanFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the meanFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricMeanFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricMeanFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on varFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialVarFit(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/histVarFit/deVarFit.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the varFit
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getHistoricVarFit(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getHistoricVarFit(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on finalFit
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialFinalFits(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/finalFits/deFinalFits.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the finalFits
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getFinalFit(0, 0);
+
+        // write the rest of the solutions
+        for (int j = 1; j < rks[0]->getPopulationSize(); ++j)
+            csv << "," << rks[i]->getFinalFit(j, 0);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on funcCalls
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialFuncCalls(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/funcCalls/deFuncCalls.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the funcCalls
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getFinalFuncCalls(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getFinalFuncCalls(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
+
+/**
+ * @brief Creates a CSV file for DE containing info on timeTaken
+ * 
+ * @param rks The objects containing the information about the optimization process
+ */
+void differentialTimeTaken(RecordKeeper** rks)
+{
+    // set the filename (and path) for the csv
+    string pathName = "results/DE/timeTaken/deTimeTaken.csv";
+
+    // create or open the csv
+    ofstream csv(pathName);
+    
+    //for each function, write the timeTaken
+    for (int i = 0; i < rks[0]->getNumFuncs(); ++i)
+    {
+        // write the first cost to prevent extra commas
+        csv << rks[i]->getTimeTaken(0);
+
+        // write the rest of the experimentations
+        for (int j = 1; j < rks[0]->getExperimentations(); ++j)
+            csv << "," << rks[i]->getTimeTaken(j);
+        
+        // add a newline
+        csv << '\n';
+    }
+
+    // close the csv file
+    csv.close();
+}
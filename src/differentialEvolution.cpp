@@ -0,0 +1,419 @@
+/**
+ * @file differentialEvolution.cpp
+ * @author Matthew Harker
+ * @brief Optimizes a population using Differential Evolution
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+
+#include "csv.h"
+#include "differentialEvolution.h"
+#include "Island.h"
+#include "runFuncs.h"
+#include "sampling.h"
+
+using namespace std;
+
+/**
+ * @brief Runs Differential Evolution on the pool, a generation at a
+ *          time, for every function of every replicate. The CSV files
+ *          are written once the last function finishes.
+ *
+ * @param pops       The array of Population objects to be optimized
+ * @param rks        The array of RecordKeeper objects to record the optimization process
+ * @param replicates How many independent runs each function gets
+ * @param pool       The pool of threads to run on
+ * @param group      The group the tasks are added to
+ */
+void differentialEvolution(Population** pops, RecordKeeper** rks, const int replicates, ThreadPool* pool, TaskGroup* group)
+{
+    cout << "Starting Differential Evolution...\n";
+
+    // how many runs have not finished yet
+    int runs = pops[0]->getNumFuncs() * replicates;
+    shared_ptr<atomic<int>> remaining(new atomic<int>(runs));
+
+    // one evaluation per solution each generation, plus the starting population
+    for (int i = 0; i < runs; ++i)
+    {
+        double evals = double(pops[i]->getExperimentations() + 1) * pops[i]->getPopSize();
+        double cost  = evals * functionCost(pops[i]->getFunction(), pops[i]->getSolutionSize());
+
+        Optimizer* opt = makeOptimizer(pops[i], rks[i], makeDifferentialEvolution, acceptDifferential);
+
+        scheduleOptimizer(opt, pool, group, cost, [=]{
+            delete opt;
+
+            // the last run to finish writes the results
+            if (--*remaining == 0)
+            {
+                cout << "Differential Evolution has completed\n";
+                differentialResults(rks, replicates, pool);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Writes every CSV file of Differential Evolution, and the
+ *          convergence curves of the replicates if there is more than one
+ *
+ * @param rks        The records of every run, replicate by replicate
+ * @param replicates How many replicates there are
+ * @param pool       The pool of threads the replicates are merged on
+ */
+void differentialResults(RecordKeeper** rks, const int replicates, ThreadPool* pool)
+{
+    differentialCSVs(rks);
+
+    // summarize the replicates as convergence curves
+    if (replicates > 1)
+    {
+        Convergence** curves = reduceReplicates(rks, replicates, &RecordKeeper::getHistoricBestFit, pool);
+        replicateCSVs(curves, rks[0]->getNumFuncs(), "results/DE/replicates/de");
+        destroyConvergence(curves, rks[0]->getNumFuncs());
+    }
+}
+
+/**
+ * @brief Construct a new DE Optimizer:: DE Optimizer object.
+ *          Step 0 of the generator is the starting population, and
+ *          generation g draws from step g + 1: member i for the trial
+ *          of solution i, and member popSize for the archive.
+ *
+ * @param newPop    The population to optimize
+ * @param newRk     Records data about the optimization process
+ */
+DEOptimizer::DEOptimizer(Population* newPop, RecordKeeper* newRk)
+    : Optimizer(newPop, newRk),
+      rng(newPop->getSeed(), ALG_DE, newPop->getFunction(), newPop->getIsland())
+{
+    int size = pop->getPopSize();
+
+    trials    = new double[size * pop->getSolutionSize()];
+    trialFits = new double[size];
+    ranks     = new int[size];
+    archived  = 0;
+
+    // only current-to-pbest keeps the parents it replaced
+    if (pop->getStrategy() == DE_CURRENT_TO_PBEST)
+        archive = new double[size * pop->getSolutionSize()];
+    else
+        archive = nullptr;
+}
+
+/**
+ * @brief Destroy the DE Optimizer:: DE Optimizer object
+ *
+ */
+DEOptimizer::~DEOptimizer()
+{
+    delete[] trials;
+    delete[] trialFits;
+    delete[] ranks;
+
+    if (archive != nullptr)
+        delete[] archive;
+}
+
+/**
+ * @brief Builds the starting population
+ *
+ */
+void DEOptimizer::initialize()
+{
+    initializeDE(pop, &rng);
+}
+
+/**
+ * @brief Runs one generation of Differential Evolution.
+ *          Every trial is built from the population as it was at the
+ *          start of the generation, so the trials are built and
+ *          evaluated in chunks across the thread pool, each from its
+ *          own stream. The parents are then replaced in index order.
+ *
+ * @param gen Which generation is being run
+ */
+void DEOptimizer::generate(const int gen)
+{
+    int size = pop->getPopSize();
+    int dims = pop->getSolutionSize();
+
+    // the per generation statistics
+    PopulationStats stats;
+
+    // start the timer
+    clock_t timer = clock();
+
+    // current-to-pbest needs to know which solutions are the best
+    if (pop->getStrategy() == DE_CURRENT_TO_PBEST)
+        rankPopulation();
+
+    // build and evaluate every trial
+    pop->forEachChunk([&](int from, int to) {
+        Random  local = rng;
+        double* mask  = new double[dims];
+
+        for (int i = from; i < to; ++i)
+        {
+            local.setStream(gen + 1, i);
+            buildTrial(&local, i, mask);
+
+            trialFits[i] = runSolution(trials + i * dims, dims, pop->getFunction());
+        }
+
+        delete [] mask;
+    });
+
+    pop->addFuncCalls(size);
+
+    // keep each trial that is at least as good as its parent
+    select(gen);
+
+    // summarize the population in one pass
+    stats = pop->getStats();
+
+    // stop the timer
+    timer = clock() - timer;
+
+    // record the results
+    updateRecordsDE(pop, rk, stats, timer, gen);
+}
+
+/**
+ * @brief Orders the solutions from best to worst, ties by index
+ *
+ */
+void DEOptimizer::rankPopulation()
+{
+    for (int i = 0; i < pop->getPopSize(); ++i)
+        ranks[i] = i;
+
+    sort(ranks, ranks + pop->getPopSize(), [this](int a, int b) {
+        if (pop->getFitness(a) != pop->getFitness(b))
+            return pop->getFitness(a) < pop->getFitness(b);
+
+        return a < b;
+    });
+}
+
+/**
+ * @brief Builds the trial of a solution: a mutant made from the
+ *          difference of other solutions, crossed over with the
+ *          solution (binomial), then clamped to the bounds.
+ *          rand/1 mutates a random solution, current-to-pbest/1
+ *          moves the solution toward one of the best and draws its
+ *          second difference vector from the population and archive.
+ *          Every element is mutated and then selected without
+ *          branching, so the loops over the elements vectorize.
+ *
+ * @param local The generator of the trial, already on its stream
+ * @param i     The index of the solution
+ * @param mask  An array of solutionSize, for the crossover draws
+ */
+void DEOptimizer::buildTrial(Random* local, const int i, double* mask)
+{
+    int     size     = pop->getPopSize();
+    int     dims     = pop->getSolutionSize();
+    double  f        = pop->getScale();
+    double  cr       = pop->getCrossover();
+    double  low      = pop->getLowerBound();
+    double  high     = pop->getUpperBound();
+    double* x        = pop->getPopulation(i);
+    double* trial    = trials + i * dims;
+    int     taken[4] = { i, -1, -1, -1 };
+
+    if (pop->getStrategy() == DE_CURRENT_TO_PBEST)
+    {
+        // the pbest is one of the best share of the population
+        int top = int(pop->getPBestRate() * size + 0.5);
+        if (top < 1)
+            top = 1;
+
+        double* best = pop->getPopulation(ranks[int(local->uniform() * top)]);
+
+        // the second solution may come from the archive
+        taken[1] = pickOther(local, size, taken, 1);
+        taken[2] = pickOther(local, size + archived, taken, 2);
+
+        double* a = pop->getPopulation(taken[1]);
+        double* b = (taken[2] < size) ? pop->getPopulation(taken[2])
+                                      : archive + (taken[2] - size) * dims;
+
+        for (int j = 0; j < dims; ++j)
+            trial[j] = x[j] + f * (best[j] - x[j]) + f * (a[j] - b[j]);
+    }
+    else
+    {
+        taken[1] = pickOther(local, size, taken, 1);
+        taken[2] = pickOther(local, size, taken, 2);
+        taken[3] = pickOther(local, size, taken, 3);
+
+        double* a = pop->getPopulation(taken[1]);
+        double* b = pop->getPopulation(taken[2]);
+        double* c = pop->getPopulation(taken[3]);
+
+        for (int j = 0; j < dims; ++j)
+            trial[j] = a[j] + f * (b[j] - c[j]);
+    }
+
+    // one element always comes from the mutant
+    int forced = int(local->uniform() * dims);
+    local->fillUniform(mask, dims);
+
+    for (int j = 0; j < dims; ++j)
+    {
+        double value = (mask[j] < cr || j == forced) ? trial[j] : x[j];
+
+        // check the bounds
+        value = (value > high) ? high : value;
+        value = (value < low)  ? low  : value;
+
+        trial[j] = value;
+    }
+}
+
+/**
+ * @brief Replaces each solution whose trial is at least as good.
+ *          With current-to-pbest, a parent that is strictly beaten
+ *          goes to the archive, which holds up to popSize parents and
+ *          then replaces one at random.
+ *
+ * @param gen Which generation is being run
+ */
+void DEOptimizer::select(const int gen)
+{
+    int size = pop->getPopSize();
+    int dims = pop->getSolutionSize();
+
+    // the archive draws from its own stream of the generation
+    rng.setStream(gen + 1, size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        if (trialFits[i] > pop->getFitness(i))
+            continue;
+
+        if (archive != nullptr && trialFits[i] < pop->getFitness(i))
+        {
+            int index;
+
+            if (archived < size)
+                index = archived++;
+            else
+                index = int(rng.uniform() * size);
+
+            copy(pop->getPopulation(i), pop->getPopulation(i) + dims, archive + index * dims);
+        }
+
+        pop->setPopulation(i, trials + i * dims);
+        pop->setFitness(i, trialFits[i]);
+    }
+}
+
+/**
+ * @brief Builds the Differential Evolution optimizer of a population
+ *
+ * @param pop           The population to optimize
+ * @param rk            Records data about the optimization process
+ * @return Optimizer*   The optimizer, which the caller deletes
+ */
+Optimizer* makeDifferentialEvolution(Population* pop, RecordKeeper* rk)
+{
+    return new DEOptimizer(pop, rk);
+}
+
+/**
+ * @brief Takes a migrant from another island into the population,
+ *          in place of the worst solution if it beats it
+ *
+ * @param pop       The population of the island
+ * @param migrant   The solution of the migrant
+ * @param fitness   The fitness of the migrant
+ */
+void acceptDifferential(Population* pop, double* migrant, double fitness)
+{
+    pop->replaceWorst(migrant, fitness);
+}
+
+/**
+ * @brief Initializes a population to be optimized
+ *
+ * @param pop The population to initialize
+ * @param rng The random number generator of the run
+ */
+void initializeDE(Population* pop, Random* rng)
+{
+    // spread the solutions over the search space
+    initializePopulation(pop, rng);
+
+    // generate the fitness array
+    pop->generateAllFitness();
+
+    // reset the function calls
+    pop->resetFuncCalls();
+}
+
+/**
+ * @brief Draws an index that is not one of the indices already taken.
+ *          If there are too few indices to avoid them all, any index
+ *          is returned.
+ *
+ * @param rng       The random number generator of the trial
+ * @param range     The indices to draw from, [0, range)
+ * @param taken     The indices already taken
+ * @param count     How many indices are taken
+ * @return int      The index
+ */
+int pickOther(Random* rng, const int range, const int* taken, const int count)
+{
+    int  pick;
+    bool clash;
+
+    do
+    {
+        pick  = int(rng->uniform() * range);
+        clash = false;
+
+        for (int t = 0; t < count; ++t)
+            if (taken[t] == pick)
+                clash = true;
+    }
+    while (clash && range > count);
+
+    return pick;
+}
+
+/**
+ * @brief Updates a RecordKeeper object based on the most recent generation
+ *
+ * @param pop   The population object to get info from
+ * @param rk    The RecordKeeper object to write info to
+ * @param stats The statistics of the fitness array of the generation
+ * @param timer Records the length of the generation
+ * @param iter  Which generation is being recorded
+ */
+void updateRecordsDE(Population* pop, RecordKeeper* rk, const PopulationStats& stats, const clock_t timer, const int iter)
+{
+    // save the time taken and the function calls
+    rk->setTimeTaken(double(timer*1000)/CLOCKS_PER_SEC, iter);
+    rk->setFinalFuncCalls(pop->getFuncCalls(), iter);
+
+    // add the current fitness to the records
+    rk->setHistoricFit(pop->getFitness(), iter);
+
+    // record the best, worst, mean, and variance of the fitness
+    rk->setHistoricBestFit(pop->getFitness(stats.bestIndex), iter);
+    rk->setHistoricWorstFit(pop->getFitness(stats.worstIndex), iter);
+    rk->setHistoricMeanFit(stats.mean, iter);
+    rk->setHistoricVarFit(stats.variance, iter);
+
+    pop->resetFuncCalls();
+}
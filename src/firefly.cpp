@@ -10,119 +10,319 @@
  * 
  */
 #include <ctime>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <random>
-#include <thread>
 
+#include "csv.h"
 #include "firefly.h"
+#include "Island.h"
+#include "KdTree.h"
 #include "runFuncs.h"
+#include "sampling.h"
 
 using namespace std;
 
 /**
- * @brief Threads a series of Population and RecordKeeper object
- *          to be optimized by the firefly optimization algorithm
+ * @brief Runs a series of Population and RecordKeeper object on the
+ *          pool, a generation at a time, to be optimized by the
+ *          firefly optimization algorithm.
+ *          The CSV files are written once the last function finishes.
  * 
- * @param pops  The array of Population objects to be optimized
- * @param rks   The array of RecordKeeper objects to record the optimization process
+ * @param pops       The array of Population objects to be optimized
+ * @param rks        The array of RecordKeeper objects to record the optimization process
+ * @param replicates How many independent runs each function gets
+ * @param pool       The pool of threads to run on
+ * @param group      The group the tasks are added to
  */
-void firefly(Population** pops, RecordKeeper** rks)
+void firefly(Population** pops, RecordKeeper** rks, const int replicates, ThreadPool* pool, TaskGroup* group)
 {
     cout << "Starting firefly optimization\n";
 
-    // create the threads
-    int funcs = pops[0]->getNumFuncs();
-    thread* myThreads = new thread[funcs];
+    // how many runs have not finished yet
+    int runs = pops[0]->getNumFuncs() * replicates;
+    shared_ptr<atomic<int>> remaining(new atomic<int>(runs));
 
-    // start the threads
-    for (int i = 0; i < funcs; ++i)
-        myThreads[i] = thread(runFirefly, pops[i], rks[i]);
-    
-    // join the threads
-    for (int i = 0; i < funcs; ++i)
-        myThreads[i].join();
+    // schedule the runs, costed by their expected evaluations (about half the pairs move)
+    for (int i = 0; i < runs; ++i)
+    {
+        // the optimizer compares with everyone once the neighbours would be everyone
+        int looks = pops[i]->getPopSize();
+        if (pops[i]->getNearest() > 0 && pops[i]->getNearest() < looks - 1)
+            looks = pops[i]->getNearest();
+
+        double evals = 0.5 * pops[i]->getExperimentations() * pops[i]->getPopSize() * looks;
+        double cost  = evals * functionCost(pops[i]->getFunction(), pops[i]->getSolutionSize());
+
+        Optimizer* opt = makeOptimizer(pops[i], rks[i], makeFirefly, acceptFirefly);
 
-    delete [] myThreads;
+        scheduleOptimizer(opt, pool, group, cost, [=]{
+            delete opt;
 
-    cout << "Firefly optimization has completed\n";
+            // the last run to finish writes the results
+            if (--*remaining == 0)
+            {
+                cout << "Firefly optimization has completed\n";
+                fireflyResults(rks, replicates, pool);
+            }
+        });
+    }
 }
 
 /**
- * @brief Optimizes a population using the firefly optimization algorithm
+ * @brief Writes every CSV file of Firefly, and the convergence
+ *          curves of the replicates if there is more than one
  * 
- * @param pop   The population to optimize
- * @param rk    Records data about the optimization process
+ * @param rks        The records of every run, replicate by replicate
+ * @param replicates How many replicates there are
+ * @param pool       The pool of threads the replicates are merged on
  */
-void runFirefly(Population* pop, RecordKeeper* rk)
+void fireflyResults(RecordKeeper** rks, const int replicates, ThreadPool* pool)
 {
-    // initialize the fireflies
-    initializeFFO(pop);
-    
-    // variables for the algorithm
+    fireflyCSVs(rks);
+
+    // summarize the replicates as convergence curves
+    if (replicates > 1)
+    {
+        Convergence** curves = reduceReplicates(rks, replicates, &RecordKeeper::getHistoricBestFit, pool);
+        replicateCSVs(curves, rks[0]->getNumFuncs(), "results/FFA/replicates/ffa");
+        destroyConvergence(curves, rks[0]->getNumFuncs());
+    }
+}
+
+/**
+ * @brief Construct a new Firefly Optimizer:: Firefly Optimizer object.
+ *          The generator is seeded once from the master seed.
+ * 
+ * @param newPop    The population to optimize
+ * @param newRk     Records data about the optimization process
+ */
+FireflyOptimizer::FireflyOptimizer(Population* newPop, RecordKeeper* newRk)
+    : Optimizer(newPop, newRk),
+      rng(newPop->getSeed(), ALG_FFA, newPop->getFunction(), newPop->getIsland())
+{
+    int size = pop->getPopSize();
+
+    newPos = new double[pop->getSolutionSize()];
+
+    // looking at the nearest few only pays off if they are not everyone
+    nearest = pop->getNearest();
+    if (nearest >= size - 1)
+        nearest = 0;
+
+    if (nearest > 0)
+    {
+        neighbours = new int[size * nearest];
+        dist       = nullptr;
+        norms      = nullptr;
+        versions   = nullptr;
+    }
+    else
+    {
+        neighbours = nullptr;
+        dist       = new double[size * size];
+        norms      = new double[size];
+        versions   = new int[size];
+    }
+}
+
+/**
+ * @brief Destroy the Firefly Optimizer:: Firefly Optimizer object
+ * 
+ */
+FireflyOptimizer::~FireflyOptimizer()
+{
+    // destroy the newPosition array and the distances
+    delete[] newPos;
+
+    if (dist != nullptr)
+        delete[] dist;
+    if (norms != nullptr)
+        delete[] norms;
+    if (versions != nullptr)
+        delete[] versions;
+    if (neighbours != nullptr)
+        delete[] neighbours;
+}
+
+/**
+ * @brief Builds the starting fireflies, and their distances if every
+ *          pair is compared. The distances are only computed in full
+ *          here; after that each replaced firefly refreshes its own row.
+ * 
+ */
+void FireflyOptimizer::initialize()
+{
+    initializeFFO(pop, &rng);
+
+    if (dist != nullptr)
+    {
+        ffDistanceMatrix(pop, dist, norms);
+
+        for (int s = 0; s < pop->getPopSize(); ++s)
+            versions[s] = pop->getSlotVersion(s);
+    }
+}
+
+/**
+ * @brief Recalculates the distances of a firefly that took over a slot
+ * 
+ * @param ff The index of the firefly
+ */
+void FireflyOptimizer::refreshDistances(const int ff)
+{
+    int s = pop->getSlot(ff);
+
+    ffDistanceRow(pop, dist, norms, ff);
+    versions[s] = pop->getSlotVersion(s);
+}
+
+/**
+ * @brief Runs one generation of the firefly optimization algorithm
+ * 
+ * @param t Which generation is being run
+ */
+void FireflyOptimizer::generate(const int t)
+{
+    // start the timer
+    clock_t timer = clock();
+
+    // each iteration draws from its own stream
+    rng.setStream(t + 1, 0);
+
+    if (nearest > 0)
+        sweepNearest();
+    else
+        sweepAll();
+
+    // summarize the fireflies in one pass
+    PopulationStats stats = pop->getStats();
+
+    // stop the timer
+    timer = clock() - timer;
+
+    // record the results
+    recordInfo(pop, rk, stats, timer, t);
+}
+
+/**
+ * @brief Compares every firefly with every brighter one, moving the
+ *          dimmer of each pair toward the brighter.
+ *          Both intensities of a pair are dimmed by the same positive
+ *          factor, so a firefly can only attract one with a worse
+ *          fitness. The population is kept sorted, so those are the
+ *          fireflies before it, up to the first that is not better;
+ *          no later one is either, and the sweep moves on without
+ *          looking at the distances of the rest.
+ *          The distances are kept from one generation to the next,
+ *          so only the slots that were replaced since (by migrants)
+ *          are recalculated, in O(n d) each.
+ * 
+ */
+void FireflyOptimizer::sweepAll()
+{
+    int     size  = pop->getPopSize();
+    double  r;
+
+    // catch up on the fireflies that arrived between generations (eq 3)
+    for (int s = 0; s < size; ++s)
+        if (versions[s] != pop->getSlotVersion(s))
+            refreshDistances(pop->getSlotOwner(s));
+
+    // for each firefly
+    for (int i = 0; i < size; ++i)
+    {
+        // compare with each brighter firefly
+        for (int j = 0; j < i && pop->getFitness(j) < pop->getFitness(i); ++j)
+        {
+            // get the distance (eq 3, 2)
+            r = sqrt(dist[pop->getSlot(i) * size + pop->getSlot(j)]);
+
+            // only move the firefly if it is worse, with one attenuation for both
+            double att = attenuation(pop, r);
+
+            if (pop->getFitness(j) * att < pop->getFitness(i) * att)
+            {                  
+                // (get a new position for a firefly)
+                newPosition(pop, &rng, newPos, r, i, j);
+                // evaluate and update the worst firefly in the population (eqn 4)
+                int index = addNewFirefly(pop, newPos);
+
+                // the new firefly took over the dropped one's slot
+                refreshDistances(index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compares every firefly with its nearest neighbours only,
+ *          found once per generation with a k-d tree. A generation
+ *          costs O(n log n) searches and O(nk) comparisons instead
+ *          of O(n^2).
+ * 
+ */
+void FireflyOptimizer::sweepNearest()
+{
+    int     size  = pop->getPopSize();
     double  r;
-    double* newPos = new double[pop->getSolutionSize()];
-    clock_t timer;
 
-    // for each iteration
-    for (int t = 0; t < pop->getExperimentations(); ++t)
+    // find the neighbours of the generation at once, by slot
+    ffNearest(pop, nearest, neighbours);
+
+    // for each firefly
+    for (int i = 0; i < size; ++i)
     {
-        // start the timer
-        timer = clock();
+        int* near = neighbours + pop->getSlot(i) * nearest;
 
-        // for each firefly
-        for (int i = 0; i < pop->getPopSize(); ++i)
+        // compare with each of its neighbours
+        for (int n = 0; n < nearest; ++n)
         {
-            // compare with each other firefly
-            for (int j = 0; j < pop->getPopSize(); ++j)
+            // the neighbour may have moved, or been replaced, since
+            int j = pop->getSlotOwner(near[n]);
+
+            // only a brighter firefly can attract, whatever the distance
+            if (pop->getFitness(j) >= pop->getFitness(i))
+                continue;
+
+            // get the distance (eq 3, 2)
+            r = ffDistance(pop, i, j);
+
+            // only move the firefly if it is worse, with one attenuation for both
+            double att = attenuation(pop, r);
+
+            if (pop->getFitness(j) * att < pop->getFitness(i) * att)
             {
-                // get the distance (eq 3, 2)
-                r = ffDistance(pop, i, j);
-
-                // only move the firefly if it is worse
-                if (intensity(pop, j, r) < intensity(pop, i, r))
-                {                  
-                    // (get a new position for a firefly)
-                    newPosition(pop, newPos, r, i, j);
-                    // evaluate and update the worst firefly in the population (eqn 4)
-                    addNewFirefly(pop, newPos);
-
-                    // calculate the new fitness
-                }
+                newPosition(pop, &rng, newPos, r, i, j);
+                addNewFirefly(pop, newPos);
             }
         }
-        // stop the timer
-        timer = clock() - timer;
-
-        // record the results
-        recordInfo(pop, rk, timer, t);
     }
+}
 
-    // record the final fitnesses
-    for (int i = 0; i < pop->getPopSize(); ++i)
-        rk->setFinalFit(pop->getFitness(i), i, 0);
-    
-    // destroy the newPosition array
-    delete[] newPos;
+/**
+ * @brief Builds the firefly optimizer of a population
+ * 
+ * @param pop           The population to optimize
+ * @param rk            Records data about the optimization process
+ * @return Optimizer*   The optimizer, which the caller deletes
+ */
+Optimizer* makeFirefly(Population* pop, RecordKeeper* rk)
+{
+    return new FireflyOptimizer(pop, rk);
 }
 
 /**
  * @brief Initializes a population to be optimized
  * 
  * @param pop The population to be initialized
+ * @param rng The random number generator of the run
  */
-void initializeFFO(Population* pop)
+void initializeFFO(Population* pop, Random* rng)
 {
-    // set up random number generation using mersenne twister 19937
-    random_device rd;
-    mt19937 mt(rd());
-
-    // set up random distributions
-    uniform_real_distribution<double> distr(pop->getLowerBound(), pop->getUpperBound());
-
-    // initialize each value to a random value
-    for (int i = 0; i < pop->getPopSize(); ++i)
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
-            pop->setPopulation(i, j, distr(mt));
+    // spread the fireflies over the search space
+    initializePopulation(pop, rng);
     
     // generate the fitness array
     pop->generateAllFitness();
@@ -146,13 +346,27 @@ void initializeFFO(Population* pop)
 double intensity(Population* pop, const int ff, double r)
 {
     double intensity = pop->getFitness(ff);
-    double gamma     = pop->getGamma();
 
-    intensity *= exp(-gamma * pow(r, 2.0));
+    intensity *= attenuation(pop, r);
 
     return intensity;
 }
 
+/**
+ * @brief Returns how much light is absorbed over a distance, the
+ *          factor every intensity at that distance is scaled by
+ * 
+ * @param pop       The population to get information from
+ * @param r         The distance the light travels
+ * @return double   The fraction of the light that is left
+ */
+double attenuation(Population* pop, double r)
+{
+    double gamma = pop->getGamma();
+
+    return exp(-gamma * pow(r, 2.0));
+}
+
 
 /**
  * @brief Returns a value for beta based on the distance between
@@ -200,38 +414,226 @@ double ffDistance(Population* pop, const int ff1, const int ff2)
 }
 
 
+/**
+ * @brief Calculates the squared distances between one firefly and a
+ *          block of others as |a|^2 + |b|^2 - 2a.b, using the squared
+ *          lengths already in norms. Four fireflies are handled at
+ *          once so their dot products share each load of the first.
+ *          Both (a, b) and (b, a) are written, indexed by slot.
+ * 
+ * @param pop   The population to retreive positions from
+ * @param dist  The popSize x popSize matrix of squared distances
+ * @param norms The squared length of the firefly in each slot
+ * @param ff    The index of the firefly
+ * @param from  The index of the first firefly of the block
+ * @param to    One past the index of the last firefly of the block
+ */
+static void distanceBlock(Population* pop, double* dist, const double* norms,
+                          const int ff, const int from, const int to)
+{
+    int     size = pop->getPopSize();
+    int     dims = pop->getSolutionSize();
+    int     s    = pop->getSlot(ff);
+    double* a    = pop->getPopulation(ff);
+    double  dot[4];
+    int     j    = from;
+
+    while (j < to)
+    {
+        int count = (to - j < 4) ? to - j : 4;
+
+        if (count == 4)
+        {
+            double* b0 = pop->getPopulation(j);
+            double* b1 = pop->getPopulation(j+1);
+            double* b2 = pop->getPopulation(j+2);
+            double* b3 = pop->getPopulation(j+3);
+            double  d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+
+            for (int k = 0; k < dims; ++k)
+            {
+                d0 += a[k] * b0[k];
+                d1 += a[k] * b1[k];
+                d2 += a[k] * b2[k];
+                d3 += a[k] * b3[k];
+            }
+
+            dot[0] = d0; dot[1] = d1; dot[2] = d2; dot[3] = d3;
+        }
+        else
+        {
+            for (int c = 0; c < count; ++c)
+            {
+                double* b = pop->getPopulation(j+c);
+                dot[c] = 0;
+
+                for (int k = 0; k < dims; ++k)
+                    dot[c] += a[k] * b[k];
+            }
+        }
+
+        for (int c = 0; c < count; ++c)
+        {
+            int    other = pop->getSlot(j+c);
+            double sq    = norms[s] + norms[other] - 2.0 * dot[c];
+
+            // rounding can push the distance of close fireflies below 0
+            if (sq < 0.0)
+                sq = 0.0;
+
+            dist[s * size + other] = sq;
+            dist[other * size + s] = sq;
+        }
+
+        j += count;
+    }
+}
+
+/**
+ * @brief Returns the squared length of a firefly
+ * 
+ * @param pop       The population to retreive positions from
+ * @param ff        The index of the firefly
+ * @return double   The squared length
+ */
+static double squaredNorm(Population* pop, const int ff)
+{
+    double* a   = pop->getPopulation(ff);
+    double  sum = 0;
+
+    for (int k = 0; k < pop->getSolutionSize(); ++k)
+        sum += a[k] * a[k];
+
+    return sum;
+}
+
+/**
+ * @brief Calculates the squared distance between every pair of fireflies.
+ *          The lower triangle is cut into tiles of FF_TILE x FF_TILE
+ *          fireflies, so the rows of a tile stay in cache while they are
+ *          paired, and each tile is mirrored into the upper triangle.
+ *          Chunks of rows are spread across the thread pool.
+ * 
+ * @param pop   The population to retreive positions from
+ * @param dist  The popSize x popSize matrix of squared distances, by slot
+ * @param norms The squared length of the firefly in each slot
+ */
+void ffDistanceMatrix(Population* pop, double* dist, double* norms)
+{
+    const int FF_TILE = 32;
+    int size = pop->getPopSize();
+
+    pop->forEachChunk([=](int from, int to) {
+        for (int i = from; i < to; ++i)
+            norms[pop->getSlot(i)] = squaredNorm(pop, i);
+    });
+
+    pop->forEachChunk([=](int from, int to) {
+        for (int it = from; it < to; it += FF_TILE)
+        {
+            int itEnd = (it + FF_TILE < to) ? it + FF_TILE : to;
+
+            for (int jt = 0; jt < itEnd; jt += FF_TILE)
+            {
+                for (int i = it; i < itEnd; ++i)
+                {
+                    int jtEnd = (jt + FF_TILE < i) ? jt + FF_TILE : i;
+
+                    if (jt < jtEnd)
+                        distanceBlock(pop, dist, norms, i, jt, jtEnd);
+                }
+            }
+
+            for (int i = it; i < itEnd; ++i)
+                dist[pop->getSlot(i) * size + pop->getSlot(i)] = 0.0;
+        }
+    });
+}
+
+/**
+ * @brief Recalculates the distances of one firefly to every other,
+ *          after it has been replaced
+ * 
+ * @param pop   The population to retreive positions from
+ * @param dist  The popSize x popSize matrix of squared distances, by slot
+ * @param norms The squared length of the firefly in each slot
+ * @param ff    The index of the firefly
+ */
+void ffDistanceRow(Population* pop, double* dist, double* norms, const int ff)
+{
+    int s = pop->getSlot(ff);
+
+    norms[s] = squaredNorm(pop, ff);
+    distanceBlock(pop, dist, norms, ff, 0, pop->getPopSize());
+
+    dist[s * pop->getPopSize() + s] = 0.0;
+}
+
+
+/**
+ * @brief Finds the nearest fireflies to each firefly with a k-d tree
+ *          over the whole population. The searches are spread across
+ *          the thread pool.
+ * 
+ * @param pop           The population to retreive positions from
+ * @param k             How many neighbours each firefly gets
+ * @param neighbours    popSize x k, the slots of the neighbours of each slot, closest first
+ */
+void ffNearest(Population* pop, const int k, int* neighbours)
+{
+    int size = pop->getPopSize();
+
+    // the tree indexes the fireflies by slot
+    double** rows = new double*[size];
+    for (int i = 0; i < size; ++i)
+        rows[pop->getSlot(i)] = pop->getPopulation(i);
+
+    KdTree tree(rows, size, pop->getSolutionSize());
+
+    pop->forEachChunk([&](int from, int to) {
+        for (int i = from; i < to; ++i)
+        {
+            int s = pop->getSlot(i);
+            tree.nearest(rows[s], s, k, neighbours + s * k);
+        }
+    });
+
+    delete [] rows;
+}
+
+
 /**
  * @brief Creates a new firefly based on the positions of two pre-existing fireflies
  * 
  * @param pop       The population to retreive fireflies from
+ * @param rng       The random number generator of the run
  * @param newPos    The new firefly to generate
  * @param r         The distance between the two fireflies
  * @param ff1       The index of the first firefly
  * @param ff2       The index of the second firefly
  */
-void newPosition(Population* pop, double* newPos, const int r, const int ff1, const int ff2)
+void newPosition(Population* pop, Random* rng, double* newPos, const int r, const int ff1, const int ff2)
 {
-    // set up random number generation
-    random_device rd;
-    mt19937 mt(rd());
-    normal_distribution<double>  distN(0,1);
+    // draw the normal values of every dimension into newPos as one block
+    rng->fillNormal(newPos, pop->getSolutionSize());
     double rnd;
 
     // retreive and create other variables
     double alpha = pop->getAlpha();
+    double beta  = newBeta(pop, r);
+    double range = pop->getUpperBound() - pop->getLowerBound();
     double pos;
 
     // adjust the position of each dimension
     for (int i = 0; i < pop->getSolutionSize(); ++i)
     {
-        // retreive a random value and ensure it is not 0, then modify it
-        do {rnd = distN(mt);} while (rnd == 0.0);
-        rnd -= 0.5;
-        rnd *= pop->getUpperBound() - pop->getLowerBound();
+        // retreive the random value, then modify it
+        rnd  = newPos[i] - 0.5;
+        rnd *= range;
 
         // calcualte the movement
         pos  = pop->getPopulation(ff1, i);
-        pos += newBeta(pop, r) * (pop->getPopulation(ff2, i) - pop->getPopulation(ff1, i));
+        pos += beta * (pop->getPopulation(ff2, i) - pop->getPopulation(ff1, i));
         pos += alpha * rnd;
 
         // check the bounds
@@ -252,61 +654,50 @@ void newPosition(Population* pop, double* newPos, const int r, const int ff1, co
  * 
  * @param pop       The population to insert the firefly into
  * @param newPos    The new firefly to add to the population
+ * @return int      The index the firefly was placed at
  */
-void addNewFirefly(Population* pop, double* newPos)
+int addNewFirefly(Population* pop, double* newPos)
 {
     // get the new position's fitness
     double newFit = runSolution(newPos, pop->getSolutionSize(), pop->getFunction());
     pop->incrimentFuncCalls();
 
-    // variables for the new position
-    int    index = 0;
-    double curFit;
-
-    // find the index to move it to, go from best to worst
-    while (index < pop->getPopSize()-1)
-    {
-        // get the fitness to compare to
-        curFit = pop->getFitness(index);
-
-        // if the current fitness is worse than the new one
-        if (newFit < curFit)
-            break;
-        else
-            ++index;
-    }
-
-    // going backwards, shift the worse fireflys down
-    for (int i = pop->getPopSize()-1; i > index; --i)
-    {
-        // replace each dimension with the one ahead of it
-        pop->setPopulation(i, pop->getPopulation(i-1));
-
-        // replace the fitnesses with the one before it
-        pop->setFitness(i, pop->getFitness(i-1));
-    }
+    // shift the worse fireflies down and put the new one in its place
+    return pop->insertSorted(newPos, newFit);
+}
 
-    // replace the values at the index
-    pop->setPopulation(index, newPos);
 
-    // replace the fitnes
-    pop->setFitness(index, newFit);
+/**
+ * @brief Takes a migrant from another island into the population.
+ *          It is inserted in its sorted position if it beats the
+ *          worst firefly, which is removed.
+ * 
+ * @param pop       The population of the island
+ * @param migrant   The solution of the migrant
+ * @param fitness   The fitness of the migrant
+ */
+void acceptFirefly(Population* pop, double* migrant, double fitness)
+{
+    if (fitness < pop->getFitness(pop->getPopSize()-1))
+        pop->insertSorted(migrant, fitness);
 }
 
-
 /**
  * @brief Records the results of an experimentation to a RecordKeeper object
  * 
  * @param pop       The population to get info from
  * @param rk        The RecordKeeper object to record to
+ * @param stats     The statistics of the fitness array of the experiment
  * @param timer     How long each experiment took (in ms)
  * @param expr      Which experiment just finished
  */
-void recordInfo(Population* pop, RecordKeeper* rk, clock_t timer, const int expr)
+void recordInfo(Population* pop, RecordKeeper* rk, const PopulationStats& stats, clock_t timer, const int expr)
 {
     // record the results
-    rk->setHistoricBestFit(pop->getFitness(0), expr);
-    rk->setHistoricWorstFit(pop->getFitness(pop->getPopSize()-1), expr);
+    rk->setHistoricBestFit(pop->getFitness(stats.bestIndex), expr);
+    rk->setHistoricWorstFit(pop->getFitness(stats.worstIndex), expr);
+    rk->setHistoricMeanFit(stats.mean, expr);
+    rk->setHistoricVarFit(stats.variance, expr);
     rk->setTimeTaken(double(timer*1000)/CLOCKS_PER_SEC, expr);
     rk->setFinalFuncCalls(pop->getFuncCalls(), expr);
     pop->resetFuncCalls();
@@ -9,127 +9,214 @@
  * @copyright Copyright (c) 2019
  * 
  */
+#include <atomic>
 #include <iostream>
-#include <random>
-#include <thread>
+#include <memory>
 
+#include "csv.h"
 #include "harmony.h"
+#include "Island.h"
 #include "runFuncs.h"
+#include "sampling.h"
 
 using namespace std;
 
 /**
- * @brief Threads the algorithm so each thread runs the population
- *          through a specific function
+ * @brief Runs the algorithm on the pool so each run takes the population
+ *          through a specific function, a generation at a time. The CSV files are written once
+ *          the last function finishes.
  * 
- * @param pops  The array of Population objects
- * @param rks   The array of RecordKeeper objects
+ * @param pops       The array of Population objects
+ * @param rks        The array of RecordKeeper objects
+ * @param replicates How many independent runs each function gets
+ * @param pool       The pool of threads to run on
+ * @param group      The group the tasks are added to
  */
-void harmony(Population** pops, RecordKeeper** rks)
+void harmony(Population** pops, RecordKeeper** rks, const int replicates, ThreadPool* pool, TaskGroup* group)
 {
     cout << "Starting Harmony Search algorithm...\n";
 
-    int funcs = pops[0]->getNumFuncs();
-    thread* myThreads = new thread[funcs];
+    int runs = pops[0]->getNumFuncs() * replicates;
+    shared_ptr<atomic<int>> remaining(new atomic<int>(runs));
 
-    for (int i = 0; i < funcs; ++i)
-        myThreads[i] = thread(runHarmony, pops[i], rks[i]);
-    
-    for (int i = 0; i < funcs; ++i)
-        myThreads[i].join();
+    // one evaluation per harmony of each batch, plus the starting population
+    for (int i = 0; i < runs; ++i)
+    {
+        int    batch = (pops[i]->getBatchSize() > 1) ? pops[i]->getBatchSize() : 1;
+        double evals = double(pops[i]->getExperimentations()) * batch + pops[i]->getPopSize();
+        double cost  = evals * functionCost(pops[i]->getFunction(), pops[i]->getSolutionSize());
 
-    delete [] myThreads;
-    
-    cout << "Harmony Search has completed...\n";
+        Optimizer* opt = makeOptimizer(pops[i], rks[i], makeHarmony, acceptHarmony);
+
+        scheduleOptimizer(opt, pool, group, cost, [=]{
+            delete opt;
+
+            if (--*remaining == 0)
+            {
+                cout << "Harmony Search has completed...\n";
+                harmonyResults(rks, replicates, pool);
+            }
+        });
+    }
 }
 
 /**
- * @brief Runs a population through the Harmony Search algorithm
+ * @brief Writes every CSV file of Harmony Search, and the convergence
+ *          curves of the replicates if there is more than one
  * 
- * @param pop   The population being optimized
- * @param rk    Records the information as the optimization executes
+ * @param rks        The records of every run, replicate by replicate
+ * @param replicates How many replicates there are
+ * @param pool       The pool of threads the replicates are merged on
  */
-void runHarmony(Population* pop, RecordKeeper* rk)
+void harmonyResults(RecordKeeper** rks, const int replicates, ThreadPool* pool)
 {
-    // initialize random number generation
-    random_device rd;
-    mt19937 mt(rd());
-    uniform_real_distribution<double> distr(0, 1);
-    double rnd;
+    harmonyCSVs(rks);
 
-    // variables for the algorithm
-    double* newHarm = new double[pop->getSolutionSize()];
-    double  newFit;
-    clock_t timer;
+    // summarize the replicates as convergence curves
+    if (replicates > 1)
+    {
+        Convergence** curves = reduceReplicates(rks, replicates, &RecordKeeper::getHistoricBestFit, pool);
+        replicateCSVs(curves, rks[0]->getNumFuncs(), "results/HSA/replicates/hsa");
+        destroyConvergence(curves, rks[0]->getNumFuncs());
+    }
+}
 
-    // initialize population
-    initializeHS(pop);
+/**
+ * @brief Construct a new Harmony Optimizer:: Harmony Optimizer object.
+ *          Each iteration improvises a batch of harmonies from the
+ *          current memory and evaluates them across the thread pool,
+ *          then merges the ones that beat the worst harmony in batch
+ *          order. A batch of 1 is the classic one at a time search.
+ * 
+ * @param newPop    The population being optimized
+ * @param newRk     Records the information as the optimization executes
+ */
+HarmonyOptimizer::HarmonyOptimizer(Population* newPop, RecordKeeper* newRk)
+    : Optimizer(newPop, newRk),
+      rng(newPop->getSeed(), ALG_HS, newPop->getFunction(), newPop->getIsland())
+{
+    batch    = (pop->getBatchSize() > 1) ? pop->getBatchSize() : 1;
+    newHarms = new double[batch * pop->getSolutionSize()];
+    newFits  = new double[batch];
+}
 
-    // run it $experimentation times
-    for (int i = 0; i < pop->getExperimentations(); ++i)
-    {
-        // start the timer
-        timer = clock();
+/**
+ * @brief Destroy the Harmony Optimizer:: Harmony Optimizer object
+ * 
+ */
+HarmonyOptimizer::~HarmonyOptimizer()
+{
+    // destrouy
+    delete[] newHarms;
+    delete[] newFits;
+}
 
-        // for each pitch in the harmony
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
-        {
-            if (distr(mt) <= pop->getHMCR())
-            {
-                // choose an existing harmony randomly and set it to newHarm
-                rnd = distr(mt) * pop->getPopSize();
-                newHarm[j] = pop->getPopulation(rnd, j);
+/**
+ * @brief Builds the starting harmony memory
+ * 
+ */
+void HarmonyOptimizer::initialize()
+{
+    initializeHS(pop, &rng);
+}
 
-                // adjust the pitch randomly within limits
-                if (distr(mt) <= pop->getPAR())
-                    newHarm[j] = adjustPitch(newHarm[j], pop->getBandwidth());
-            }
+/**
+ * @brief Runs one iteration of Harmony Search
+ * 
+ * @param i Which iteration is being run
+ */
+void HarmonyOptimizer::generate(const int i)
+{
+    int size = pop->getSolutionSize();
+
+    // start the timer
+    clock_t timer = clock();
 
-            // otherwise generate new harmonics via randomization
-            else
-                newHarm[j] = pop->getLowerBound() + distr(mt) * (pop->getUpperBound() - pop->getLowerBound());
+    // improvise and evaluate the batch, each harmony draws from its own stream
+    pop->forEachChunk(batch, [&](int from, int to) {
+        Random local = rng;
 
+        for (int b = from; b < to; ++b)
+        {
+            local.setStream(i + 1, b);
+            improvise(pop, &local, newHarms + b * size);
+
+            newFits[b] = runSolution(newHarms + b * size, size, pop->getFunction());
         }
-        // accept the new solutions if better
-        newFit = runSolution(newHarm, pop->getSolutionSize(), pop->getFunction());
-        pop->incrimentFuncCalls();
+    });
 
-        if (newFit < pop->getFitness(pop->getPopSize()-1));
-            addNewHarmony(pop, newHarm, newFit);
+    // accept the new solutions if better
+    for (int b = 0; b < batch; ++b)
+    {
+        pop->incrimentFuncCalls();
 
-        // end the timer
-        timer = clock() - timer;
-       
-        // update records
-        updateRecordsFF(pop, rk, timer, i);
+        if (newFits[b] < pop->getFitness(pop->getPopSize()-1))
+            addNewHarmony(pop, newHarms + b * size, newFits[b]);
     }
 
-    // record all of the final fitnesses
-    for (int i = 0; i < pop->getPopSize(); ++i)
-        rk->setFinalFit(pop->getFitness(i), i, 0);
+    // summarize the harmony memory in one pass
+    PopulationStats stats = pop->getStats();
 
-    // destrouy
-    delete[] newHarm;
+    // end the timer
+    timer = clock() - timer;
+   
+    // update records
+    updateRecordsFF(pop, rk, stats, timer, i);
 }
 
 /**
- * @brief Initializes a population to be optimized
+ * @brief Builds the Harmony Search optimizer of a population
  * 
- * @param pop The population to initialize
+ * @param pop           The population to optimize
+ * @param rk            Records the information as the optimization executes
+ * @return Optimizer*   The optimizer, which the caller deletes
  */
-void initializeHS(Population* pop)
+Optimizer* makeHarmony(Population* pop, RecordKeeper* rk)
 {
-    // set up random number generation using mersenne twister 19937
-    random_device rd;
-    mt19937 mt(rd());
+    return new HarmonyOptimizer(pop, rk);
+}
 
-    // set up random distributions
-    uniform_real_distribution<double> distr(pop->getLowerBound(), pop->getUpperBound());
+/**
+ * @brief Improvises a new harmony from the harmony memory
+ * 
+ * @param pop       The population being optimized
+ * @param rng       The random number generator of the harmony
+ * @param newHarm   The harmony to fill
+ */
+void improvise(Population* pop, Random* rng, double* newHarm)
+{
+    double rnd;
 
-    // initialize each value to a random value
-    for (int i = 0; i < pop->getPopSize(); ++i)
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
-            pop->setPopulation(i, j, distr(mt));
+    // for each pitch in the harmony
+    for (int j = 0; j < pop->getSolutionSize(); ++j)
+    {
+        if (rng->uniform() <= pop->getHMCR())
+        {
+            // choose an existing harmony randomly and set it to newHarm
+            rnd = rng->uniform() * pop->getPopSize();
+            newHarm[j] = pop->getPopulation(rnd, j);
+
+            // adjust the pitch randomly within limits
+            if (rng->uniform() <= pop->getPAR())
+                newHarm[j] = adjustPitch(newHarm[j], pop->getBandwidth(), rng);
+        }
+
+        // otherwise generate new harmonics via randomization
+        else
+            newHarm[j] = rng->uniform(pop->getLowerBound(), pop->getUpperBound());
+    }
+}
+
+/**
+ * @brief Initializes a population to be optimized
+ * 
+ * @param pop The population to initialize
+ * @param rng The random number generator of the run
+ */
+void initializeHS(Population* pop, Random* rng)
+{
+    // spread the harmonies over the search space
+    initializePopulation(pop, rng);
     
     // generate the fitness array
     pop->generateAllFitness();
@@ -146,15 +233,12 @@ void initializeHS(Population* pop)
  * 
  * @param pitch     The pitch to be adjusted
  * @param bandwidth A constant that adjusts the pitch
+ * @param rng       The random number generator of the run
  * @return double   The resulting adjustment
  */
-double adjustPitch(double pitch, double bandwidth)
+double adjustPitch(double pitch, double bandwidth, Random* rng)
 {
-    random_device rd;
-    mt19937 mt(rd());
-    uniform_real_distribution<double> distr(-1, 1);
-
-    return pitch + bandwidth * distr(mt);
+    return pitch + bandwidth * rng->uniform(-1, 1);
 }
 
 /**
@@ -170,38 +254,22 @@ double adjustPitch(double pitch, double bandwidth)
  */
 void addNewHarmony(Population* pop, double* newHarm, double newFit)
 {
-    // variables for the new position
-    int    index = 0;
-    double curFit;
-
-    // find the index to move it to, go from best to worst
-    while (index < pop->getPopSize()-1)
-    {
-        // get the fitness to compare to
-        curFit = pop->getFitness(index);
-
-        // if the current fitness is worse than the new one
-        if (newFit < curFit)
-            break;
-        else
-            ++index;
-    }
-
-    // going backwards, shift the worse fireflys down
-    for (int i = pop->getPopSize()-1; i > index; --i)
-    {
-        // replace each dimension with the one ahead of it
-        pop->setPopulation(i, pop->getPopulation(i-1));
-
-        // replace the fitnesses with the one before it
-        pop->setFitness(i, pop->getFitness(i-1));
-    }
-
-    // replace the values at the index
-    pop->setPopulation(index, newHarm);
+    // shift the worse harmonies down and put the new one in its place
+    pop->insertSorted(newHarm, newFit);
+}
 
-    // replace the fitnes
-    pop->setFitness(index, newFit);
+/**
+ * @brief Takes a migrant from another island into the harmony memory,
+ *          if it beats the worst harmony
+ * 
+ * @param pop       The population of the island
+ * @param migrant   The solution of the migrant
+ * @param fitness   The fitness of the migrant
+ */
+void acceptHarmony(Population* pop, double* migrant, double fitness)
+{
+    if (fitness < pop->getFitness(pop->getPopSize()-1))
+        addNewHarmony(pop, migrant, fitness);
 }
 
 /**
@@ -210,14 +278,17 @@ void addNewHarmony(Population* pop, double* newHarm, double newFit)
  * 
  * @param pop       The populaion being optimized
  * @param rk        The RecordKeeper object storing the information
+ * @param stats     The statistics of the harmony memory after the iteration
  * @param timer     Records the time an iteration took to complete
  * @param iter      Which iteration the population has just finished
  */
-void updateRecordsFF(Population* pop, RecordKeeper* rk, clock_t timer, const int iter)
+void updateRecordsFF(Population* pop, RecordKeeper* rk, const PopulationStats& stats, clock_t timer, const int iter)
 {
     // record data
-    rk->setHistoricBestFit(pop->getFitness(0), iter);
-    rk->setHistoricWorstFit(pop->getFitness(pop->getPopSize()-1), iter);
+    rk->setHistoricBestFit(pop->getFitness(stats.bestIndex), iter);
+    rk->setHistoricWorstFit(pop->getFitness(stats.worstIndex), iter);
+    rk->setHistoricMeanFit(stats.mean, iter);
+    rk->setHistoricVarFit(stats.variance, iter);
     rk->setTimeTaken(double(timer*1000)/CLOCKS_PER_SEC, iter);
     rk->setFinalFuncCalls(pop->getFuncCalls(), iter);
     pop->resetFuncCalls();
@@ -4,8 +4,9 @@
  * @author  Matthew Harker
  * @brief   Project 4 for CS470. This program run a population of
  *          solution vectors through Particle Swarm algorithm,
- *          Firefly algorthim, and Harmony Search algorithm then
- *          print all the results to csv files.
+ *          Firefly algorthim, Harmony Search algorithm, and
+ *          Differential Evolution then print all the results to
+ *          csv files.
  * 
  * @version 4.0
  * @date 2019-05-20
@@ -14,61 +15,212 @@
  * 
  */
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "unistd.h"
 
+#include "Affinity.h"
+#include "Coordinator.h"
 #include "csv.h"
+#include "differentialEvolution.h"
 #include "firefly.h"
 #include "harmony.h"
 #include "Parameters.h"
 #include "particleSwarm.h"
 #include "Population.h"
+#include "Random.h"
 #include "RecordKeeper.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
+Population**   createPopulations(Parameters params);
+RecordKeeper** createRecords(Parameters params);
+void destroyPopulations(Population** pops, Parameters params);
+void destroyRecords(RecordKeeper** rks, Parameters params);
+int  coordinate(Parameters params);
+
 /**
  * @brief   The Main function. This will run the Patricle Swarm,
  *              
  * 
+ * @param   argc    How many command line arguments there are
+ * @param   argv    The arguments; "--worker <socket> <index>" runs
+ *                  as a worker process of a coordinator
  * @return  int Indicates status of how the program ended.
  */
-int main()
+int main(int argc, char** argv)
 {
+    // workers are started by a coordinator and only run the jobs they are sent
+    if (argc == 4 && strcmp(argv[1], "--worker") == 0)
+        return runWorker(argv[2], atoi(argv[3]));
+
     // Create a Parameters object
     Parameters params = getParameters();
 
-    // create an array of Population objects
-    Population** pops = new Population*[params.numFuncs];
-    for (int i = 0; i < params.numFuncs; ++i)
-        pops[i] = new Population(params, i);
+    // record the master seed so the run can be reproduced
+    cout << "Master seed: " << params.seed << '\n';
+    seedCSV(params.seed);
 
-    // create an array RecordKeeper objects
-    RecordKeeper** rks = new RecordKeeper*[params.numFuncs];
-    for (int i = 0; i < params.numFuncs; ++i)
-        rks[i] = new RecordKeeper(params);
+    // shard the runs across worker processes, then write the results here
+    if (params.processes > 0)
+        return coordinate(params);
+
+    // every algorithm gets its own Population and RecordKeeper objects
+    // so all of them can run at the same time
+    Population**   psoPops = createPopulations(params);
+    Population**   ffaPops = createPopulations(params);
+    Population**   hsPops  = createPopulations(params);
+    Population**   dePops  = createPopulations(params);
+    RecordKeeper** psoRks  = createRecords(params);
+    RecordKeeper** ffaRks  = createRecords(params);
+    RecordKeeper** hsRks   = createRecords(params);
+    RecordKeeper** deRks   = createRecords(params);
 
-    // run PSO
-    particleSwarm(pops, rks);
-    particleCSVs(rks);
+    {
+        // create the pool of threads every optimization runs on
+        ThreadPool pool(params.numThreads);
+        TaskGroup  campaign;
 
-    // run FFA
-    firefly(pops, rks);
-    fireflyCSVs(rks);
+        // keep each worker on one CPU if asked to
+        pinThreads(params, &pool);
 
-    // run HS
-    harmony(pops, rks);
-    harmonyCSVs(rks);
+        // let every population split its sweeps across the pool
+        for (int i = 0; i < params.numFuncs * params.replicates; ++i)
+        {
+            psoPops[i]->setThreadPool(&pool);
+            ffaPops[i]->setThreadPool(&pool);
+            hsPops[i]->setThreadPool(&pool);
+            dePops[i]->setThreadPool(&pool);
+        }
+
+        // submit PSO, FFA, HS, and DE together; each writes its own CSVs
+        // as soon as its last function finishes
+        particleSwarm(psoPops, psoRks, params.replicates, &pool, &campaign);
+        firefly(ffaPops, ffaRks, params.replicates, &pool, &campaign);
+        harmony(hsPops, hsRks, params.replicates, &pool, &campaign);
+        differentialEvolution(dePops, deRks, params.replicates, &pool, &campaign);
+
+        // wait for everything to finish
+        pool.wait(&campaign);
+    }
 
     // destroy the Population \m/ 
-    for (int i = 0; i < params.numFuncs; ++i)
+    destroyPopulations(psoPops, params);
+    destroyPopulations(ffaPops, params);
+    destroyPopulations(hsPops, params);
+    destroyPopulations(dePops, params);
+
+    // destroy the RecordKeeper 
+    destroyRecords(psoRks, params);
+    destroyRecords(ffaRks, params);
+    destroyRecords(hsRks, params);
+    destroyRecords(deRks, params);
+
+    return 0;
+}
+
+/**
+ * @brief Creates a Population object for every function of every
+ *          replicate, replicate by replicate. Each replicate runs
+ *          from its own seed, derived from the master seed.
+ * 
+ * @param params            The parameters of the run
+ * @return Population**    The array of Population objects
+ */
+Population** createPopulations(Parameters params)
+{
+    Population** pops = new Population*[params.numFuncs * params.replicates];
+    uint64_t     seed = params.seed;
+
+    for (int r = 0; r < params.replicates; ++r)
+    {
+        params.seed = replicateSeed(seed, r);
+
+        for (int i = 0; i < params.numFuncs; ++i)
+            pops[r * params.numFuncs + i] = new Population(params, i);
+    }
+
+    return pops;
+}
+
+/**
+ * @brief Creates a RecordKeeper object for every function of every replicate
+ * 
+ * @param params            The parameters of the run
+ * @return RecordKeeper**   The array of RecordKeeper objects
+ */
+RecordKeeper** createRecords(Parameters params)
+{
+    RecordKeeper** rks = new RecordKeeper*[params.numFuncs * params.replicates];
+    for (int i = 0; i < params.numFuncs * params.replicates; ++i)
+        rks[i] = new RecordKeeper(params);
+
+    return rks;
+}
+
+/**
+ * @brief Destroys an array of Population objects
+ * 
+ * @param pops      The array to destroy
+ * @param params    The parameters of the run
+ */
+void destroyPopulations(Population** pops, Parameters params)
+{
+    for (int i = 0; i < params.numFuncs * params.replicates; ++i)
         delete pops[i];
     delete [] pops;
+}
 
-    // destroy the RecordKeeper 
-    for (int i = 0; i < params.numFuncs; ++i)
+/**
+ * @brief Destroys an array of RecordKeeper objects
+ * 
+ * @param rks       The array to destroy
+ * @param params    The parameters of the run
+ */
+void destroyRecords(RecordKeeper** rks, Parameters params)
+{
+    for (int i = 0; i < params.numFuncs * params.replicates; ++i)
         delete rks[i];
     delete [] rks;
+}
 
-    return 0;
+/**
+ * @brief Runs every algorithm on worker processes and writes the
+ *          results once the coordinator has collected every record
+ * 
+ * @param params    The parameters of the run
+ * @return int      0 on success, 1 if the campaign could not finish
+ */
+int coordinate(Parameters params)
+{
+    RecordKeeper** psoRks = createRecords(params);
+    RecordKeeper** ffaRks = createRecords(params);
+    RecordKeeper** hsRks  = createRecords(params);
+    RecordKeeper** deRks  = createRecords(params);
+
+    RecordKeeper** records[4] = { psoRks, ffaRks, hsRks, deRks };
+
+    cout << "Sharding " << jobCount(params) << " runs across "
+         << params.processes << " worker processes\n";
+
+    int status = runCoordinator(params, records);
+
+    if (status == 0)
+    {
+        ThreadPool pool(params.numThreads);
+
+        particleResults(psoRks, params.replicates, &pool);
+        fireflyResults(ffaRks, params.replicates, &pool);
+        harmonyResults(hsRks, params.replicates, &pool);
+        differentialResults(deRks, params.replicates, &pool);
+    }
+
+    destroyRecords(psoRks, params);
+    destroyRecords(ffaRks, params);
+    destroyRecords(hsRks, params);
+    destroyRecords(deRks, params);
+
+    return status;
 }
@@ -9,270 +9,482 @@
  * @copyright Copyright (c) 2019
  * 
  */
-#include <cfloat>
+#include <atomic>
 #include <iostream>
-#include <random>
-#include <thread>
+#include <memory>
 
+#include "csv.h"
+#include "Island.h"
 #include "particleSwarm.h"
+#include "runFuncs.h"
+#include "sampling.h"
 
 using namespace std;
 
 /**
- * @brief Optimizes population objects using Particle Swarm optimization
+ * @brief Optimizes population objects using Particle Swarm optimization.
+ *          Each function of each replicate is run on the pool a
+ *          generation at a time and the CSV files are written by
+ *          whichever run finishes last, so this returns as soon as
+ *          the runs are scheduled. The runs are costed by their
+ *          expected evaluations so the most expensive go first.
  * 
- * @param pops 
+ * @param pops       The array of Population objects to be optimized
+ * @param rks        The array of RecordKeeper objects to record the optimization process
+ * @param replicates How many independent runs each function gets
+ * @param pool       The pool of threads to run on
+ * @param group      The group the tasks are added to
  */
-void particleSwarm(Population** pops, RecordKeeper** rks)
+void particleSwarm(Population** pops, RecordKeeper** rks, const int replicates, ThreadPool* pool, TaskGroup* group)
 {
     cout << "Starting Particle Swarm optimization...\n";
 
-    // create threads
-    thread* myThreads = new thread[pops[0]->getNumFuncs()];
+    // how many runs have not finished yet
+    int runs = pops[0]->getNumFuncs() * replicates;
+    shared_ptr<atomic<int>> remaining(new atomic<int>(runs));
 
-    // start threads
-    for (int i = 0; i < pops[0]->getNumFuncs(); ++i)
-        myThreads[i] = thread(runParticleSwarm, pops[i], rks[i]);
-    
-    // join threads
-    for (int i = 0; i < pops[0]->getNumFuncs(); ++i)
-        myThreads[i].join();
+    // submit a task for each function of each replicate
+    for (int i = 0; i < runs; ++i)
+    {
+        double evals = double(pops[i]->getExperimentations()) * pops[i]->getSweeps() * pops[i]->getPopSize();
+
+        if (pops[i]->getEvalBudget() > 0 && evals > pops[i]->getEvalBudget())
+            evals = pops[i]->getEvalBudget();
+
+        double cost  = evals * functionCost(pops[i]->getFunction(), pops[i]->getSolutionSize());
+
+        Optimizer* opt = makeOptimizer(pops[i], rks[i], makeParticleSwarm, acceptParticle);
 
-    // destroy the threads
-    delete [] myThreads;
+        scheduleOptimizer(opt, pool, group, cost, [=]{
+            delete opt;
 
-    cout << "Particle Swarm optimization completed\n";
+            // the last run to finish writes the results
+            if (--*remaining == 0)
+            {
+                cout << "Particle Swarm optimization completed\n";
+                particleResults(rks, replicates, pool);
+            }
+        });
+    }
 }
 
 /**
- * @brief Runs each thread of PSO
+ * @brief Writes every CSV file of Particle Swarm, and the convergence
+ *          curves of the replicates if there is more than one
  * 
- * @param pop The population to optimize
+ * @param rks        The records of every run, replicate by replicate
+ * @param replicates How many replicates there are
+ * @param pool       The pool of threads the replicates are merged on
  */
-void runParticleSwarm(Population* pop, RecordKeeper* rk)
+void particleResults(RecordKeeper** rks, const int replicates, ThreadPool* pool)
 {
-    // initialize the population
-    initializePSO(pop);
-
-    // create a timer
-    clock_t timer;
+    particleCSVs(rks);
 
-    // run it X times
-    for (int i = 0; i < pop->getExperimentations(); ++i)
+    // summarize the replicates as convergence curves
+    if (replicates > 1)
     {
-        // set funcCalls to 0
-        pop->resetFuncCalls();
+        Convergence** curves = reduceReplicates(rks, replicates, &RecordKeeper::getHistoricGBest, pool);
+        replicateCSVs(curves, rks[0]->getNumFuncs(), "results/PSO/replicates/pso");
+        destroyConvergence(curves, rks[0]->getNumFuncs());
+    }
+}
 
-        // start timer
-        timer = clock();
+/**
+ * @brief Construct a new Particle Swarm Optimizer:: Particle Swarm Optimizer object.
+ *          The generator is keyed by the master seed. Step 0 is the
+ *          starting population, step 1 the starting velocities, and
+ *          the generations follow.
+ * 
+ * @param newPop    The population to optimize
+ * @param newRk     Records data about the optimization process
+ */
+ParticleSwarmOptimizer::ParticleSwarmOptimizer(Population* newPop, RecordKeeper* newRk)
+    : Optimizer(newPop, newRk),
+      rng(newPop->getSeed(), ALG_PSO, newPop->getFunction(), newPop->getIsland())
+{
+    evaluations = 0;
+}
 
-        // update the full population
-        for (int j = 0; j < pop->getPopSize(); ++j)
-        {
-            // calculate new velocity of the particle
-            updateVelocity(pop);
+/**
+ * @brief Builds the starting swarm
+ * 
+ */
+void ParticleSwarmOptimizer::initialize()
+{
+    initializePSO(pop, &rng);
 
-            // update the particle
-            updateParticles(pop);
+    // the starting swarm is paid for out of the budget too
+    evaluations = pop->getPopSize();
+}
 
-            // calculate the fitness
-            updateFitness(pop);
+/**
+ * @brief Runs one generation of PSO, which moves the full swarm
+ *          a set number of times (once per particle by default).
+ *          Once the evaluation budget is spent the swarm stays
+ *          where it is and the remaining generations record it as is.
+ * 
+ * @param gen Which generation is being run
+ */
+void ParticleSwarmOptimizer::generate(const int gen)
+{
+    // the per generation statistics
+    PopulationStats stats;
 
-            // update pBest and gBest (if necessary)
-            updatePersonalBest(pop);
-            updateGlobalBest(pop);
-        }
+    // the streams of the generation start after those of the earlier ones
+    int sweeps = pop->getSweeps();
+    int first  = 2 + gen * sweeps;
 
-        // end timer and record it
-        timer = clock() - timer;
+    // only run the sweeps that fit in what is left of the budget
+    if (pop->getEvalBudget() > 0)
+    {
+        long long left = pop->getEvalBudget() - evaluations;
 
-        // update record
-        updateRecords(pop, rk, timer, i);
+        if (left < (long long)sweeps * pop->getPopSize())
+            sweeps = (left > 0) ? int(left / pop->getPopSize()) : 0;
     }
 
-    // record the final best
-    for (int i = 0; i < pop->getPopSize(); ++i)
-        rk->setFinalFit(pop->getFitness(i), i, 0);
+    // set funcCalls to 0
+    pop->resetFuncCalls();
+
+    // start timer
+    clock_t timer = clock();
+
+    // let the particles run through the generation on their own, which
+    // only the seqlocked global best allows
+    if (pop->getUpdateMode() == PSO_ASYNC && pop->getNeighbourhood() == nullptr)
+        updateAsync(pop, &rng, first, sweeps);
+
+    // move the full swarm in lockstep
+    else for (int j = 0; j < sweeps; ++j)
+        updateSwarm(pop, &rng, first + j);
+
+    // summarize the swarm in one pass
+    stats = pop->getStats();
+
+    evaluations += (long long)sweeps * pop->getPopSize();
+
+    // end timer and record it
+    timer = clock() - timer;
+
+    // update record
+    updateRecords(pop, rk, stats, timer, gen);
 }
 
 /**
- * @brief Updates all velocities based on the particle's
- *          pBest and the population's gBest
+ * @brief Builds the PSO optimizer of a population
  * 
- * @param pop The population to update
+ * @param pop           The population to optimize
+ * @param rk            Records data about the optimization process
+ * @return Optimizer*   The optimizer, which the caller deletes
  */
-void updateVelocity(Population* pop)
+Optimizer* makeParticleSwarm(Population* pop, RecordKeeper* rk)
 {
-    // set up random number generation using mersenne twister 19937
-    random_device rd;
-    mt19937 mt(rd());
-    uniform_real_distribution<double> distr(0, 1);
+    return new ParticleSwarmOptimizer(pop, rk);
+}
+
+/**
+ * @brief Moves one particle. The velocity is pulled toward the
+ *          particle's personal best and the global best and dampened,
+ *          then the position follows it and is clamped to the bounds.
+ *          Each dimension is finished before the next, so the rows
+ *          are read and written in a single pass.
+ * 
+ * @param sol   The position of the particle
+ * @param vel   The velocity of the particle
+ * @param pBest The personal best of the particle
+ * @param gBest A copy of the global best
+ * @param rands Two random values per dimension, interleaved
+ * @param size  The size of the solution
+ * @param k     The velocity dampener
+ * @param c1    The pull of the personal best
+ * @param c2    The pull of the global best
+ * @param low   The lower bound of the search space
+ * @param high  The upper bound of the search space
+ */
+static void moveParticle(double* sol, double* vel, const double* pBest, const double* gBest,
+                         const double* rands, const int size, const double k, const double c1,
+                         const double c2, const double low, const double high)
+{
+    for (int j = 0; j < size; ++j)
+    {
+        double pull = c1 * rands[2*j]     * (pBest[j] - sol[j]);
+        pull       += c2 * rands[2*j + 1] * (gBest[j] - sol[j]);
 
+        double v = (vel[j] + pull) * k;
+        double x = sol[j] + v;
+
+        if (x > high) x = high;
+        if (x < low)  x = low;
+
+        vel[j] = v;
+        sol[j] = x;
+    }
+}
+
+/**
+ * @brief Moves the whole swarm once. Each particle is moved,
+ *          evaluated, and its personal best updated in one pass while
+ *          its rows are still in cache. Every particle follows the
+ *          global best from before the sweep, and each chunk then
+ *          offers its best new personal best as the global best,
+ *          without a lock. Only a particle that beat its personal
+ *          best can beat the global best.
+ *        With neighbourhoods each particle follows its local best
+ *          instead. Those are other particles' personal bests, so the
+ *          personal bests are only updated once every particle moved.
+ * 
+ * @param pop  The population to update
+ * @param rng  The random number generator of the run
+ * @param step Which sweep of the run is being run
+ */
+void updateSwarm(Population* pop, Random* rng, const int step)
+{
     // get the velocity constants
     double k   = pop->getDampener();
     double c1  = pop->getVelConst1();
     double c2  = pop->getVelConst2();
 
-    // variables for the algorithm
-    double vel;
-    double pos;
-    double rand1;
-    double rand2;
-    
-    for (int i = 0; i < pop->getPopSize(); ++i)
-    {
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
+    int    size = pop->getSolutionSize();
+    double low  = pop->getLowerBound();
+    double high = pop->getUpperBound();
+
+    // one copy of the global best for the whole sweep
+    Neighbourhood* hood  = pop->getNeighbourhood();
+    double*        gBest = new double[size];
+    pop->readGlobalBest(gBest);
+
+    // each chunk of particles is updated with its own copy of the generator;
+    // every particle of every sweep has its own stream, so the
+    // result does not depend on how the swarm is split
+    pop->forEachChunk([=](int from, int to) {
+        Random local = *rng;
+        int    chunkBest = -1;
+
+        // the nonzero random values of one particle, drawn as a single block
+        double* rands = new double[2 * size];
+
+        for (int i = from; i < to; ++i)
         {
-            // get the velocity
-            pos = pop->getVelocity(i, j);
+            double* sol   = pop->getPopulation(i);
+            double* pBest = pop->getPBestVec(i);
 
-            // create random variables ensure they are not 0
-            do { rand1 = distr(mt); } while (rand1 == 0.0);
-            do { rand2 = distr(mt); } while (rand2 == 0.0);
+            // follow the global best, or the best the particle can see
+            const double* follow = (hood == nullptr) ? gBest : pop->getPBestVec(hood->getBest(i));
 
-            // create and adjust the new velocity
-            vel  = c1 * rand1 * (pop->getPBestVec(i, j)   - pop->getPopulation(i, j));
-            vel += c2 * rand2 * (pop->getGlobalBestVec(j) - pop->getPopulation(i, j));
+            local.setStream(step, i);
+            local.fillUniform(rands, 2 * size);
 
-            // adjust the position and dampen it
-            pos += vel;
-            pos *= k;
+            moveParticle(sol, pop->getVelocity(i), pBest, follow, rands, size, k, c1, c2, low, high);
 
-            // set the new velocity value
-            pop->setVelocity(i, j, pos);
+            double fit = runSolution(sol, size, pop->getFunction());
+            pop->setFitness(i, fit);
+
+            // check if pBest needs to be updated
+            if (hood == nullptr && fit < pop->getPBestFit(i))
+            {
+                pop->setPBestFit(i, fit);
+                for (int j = 0; j < size; ++j)
+                    pBest[j] = sol[j];
+
+                if (chunkBest < 0 || fit < pop->getFitness(chunkBest))
+                    chunkBest = i;
+            }
         }
-    }
+
+        // check if gBest needs to be updated
+        if (chunkBest >= 0)
+            pop->offerGlobalBest(pop->getPopulation(chunkBest), pop->getFitness(chunkBest), step, chunkBest);
+
+        delete [] rands;
+    });
+
+    // count the calls once the chunks are done
+    pop->addFuncCalls(pop->getPopSize());
+
+    if (hood != nullptr)
+        updateNeighbourhood(pop, step);
+
+    delete [] gBest;
 }
 
 /**
- * @brief Updates the position of every particle.
- *          The position of the particle is updated by taking
- *          the current position and adding the velocity to it.
- *          If the velocity takes the particle out of bounds the
- *          new value is set to the relevant bound's value.
+ * @brief Updates the personal bests after a sweep with neighbourhoods.
+ *          The improved rows are copied in parallel, then the local
+ *          bests of the particles they inform are updated in order
+ *          and the best of them is offered as the global best.
  * 
- * @param pop The population to update
+ * @param pop  The population to update
+ * @param step Which sweep of the run is being run
  */
-void updateParticles(Population* pop)
+void updateNeighbourhood(Population* pop, const int step)
 {
-    // create a variable to hold info about the position
-    double newPos;
+    Neighbourhood* hood     = pop->getNeighbourhood();
+    char*          improved = new char[pop->getPopSize()];
 
-    for (int i = 0; i < pop->getPopSize(); ++i)
-    {
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
+    pop->forEachChunk([=](int from, int to) {
+        for (int i = from; i < to; ++i)
         {
-            // get a new value for the particle's element
-            newPos = pop->getPopulation(i, j) + pop->getVelocity(i, j);
-            
-            // check the bounds
-            if (newPos > pop->getUpperBound()) newPos = pop->getUpperBound();
-            if (newPos < pop->getLowerBound()) newPos = pop->getLowerBound();
-            
-            // assign the new value to the particle
-            pop->setPopulation(i, j, newPos);
+            improved[i] = pop->getFitness(i) < pop->getPBestFit(i);
+
+            if (improved[i])
+            {
+                pop->setPBestFit(i, pop->getFitness(i));
+                for (int j = 0; j < pop->getSolutionSize(); ++j)
+                    pop->setPBestVec(i, j, pop->getPopulation(i, j));
+            }
         }
+    });
+
+    int best = -1;
+
+    for (int i = 0; i < pop->getPopSize(); ++i)
+    {
+        if (!improved[i])
+            continue;
+
+        hood->improve(i, pop->getPBestFit());
+
+        if (best < 0 || pop->getFitness(i) < pop->getFitness(best))
+            best = i;
     }
-}
 
-/**
- * @brief Updates the fitnesses of the particles in the population
- * 
- * @param pop The population to update
- */
-void updateFitness(Population* pop)
-{
-    pop->generateAllFitness();
+    if (best >= 0)
+        pop->offerGlobalBest(pop->getPopulation(best), pop->getFitness(best), step, best);
+
+    delete [] improved;
 }
 
 /**
- * @brief Updates each particle's personal best.
- *          If the particle's new fitness is more optimal
- *          the the personal best, update the personal best.
+ * @brief Runs a generation of asynchronous PSO. Each particle
+ *          is moved, evaluated, and updates its personal best and the
+ *          global best in one go, reading the newest global best every
+ *          time it moves. Each chunk of particles runs every sweep of
+ *          the generation without waiting for the others, so the
+ *          result depends on how the threads interleave.
  * 
- * @param pop The population to update
+ * @param pop    The population to update
+ * @param rng    The random number generator of the run
+ * @param first  The stream of the first sweep of the generation
+ * @param sweeps How many times the swarm is moved
  */
-void updatePersonalBest(Population* pop)
+void updateAsync(Population* pop, Random* rng, const int first, const int sweeps)
 {
-    // for each particle in the population
-    for (int i = 0; i < pop->getPopSize(); ++i)
-    {
-        double curFit = pop->getFitness(i);
-        double pBest  = pop->getPBestFit(i);
+    // get the velocity constants
+    double k   = pop->getDampener();
+    double c1  = pop->getVelConst1();
+    double c2  = pop->getVelConst2();
+
+    int    size = pop->getSolutionSize();
+    double low  = pop->getLowerBound();
+    double high = pop->getUpperBound();
+
+    // the evaluations of every chunk
+    atomic<int> calls(0);
+
+    pop->forEachChunk([&](int from, int to) {
+        Random local = *rng;
 
-        // check if pBest needs to be updated
-        if (curFit < pBest)
+        // the nonzero random values of one particle, drawn as a single block
+        double* rands = new double[2 * size];
+        double* gBest = new double[size];
+
+        for (int s = 0; s < sweeps; ++s)
         {
-            // update pBestFit
-            pop->setPBestFit(i, curFit);
+            // the same streams the synchronous sweeps use
+            int step = first + s;
+
+            for (int i = from; i < to; ++i)
+            {
+                double* sol   = pop->getPopulation(i);
+                double* pBest = pop->getPBestVec(i);
+
+                local.setStream(step, i);
+                local.fillUniform(rands, 2 * size);
+                pop->readGlobalBest(gBest);
 
-            // update pBestVec
-            for (int j = 0; j < pop->getSolutionSize(); ++j)
-                pop->setPBestVec(i, j, pop->getPopulation(i, j));
+                moveParticle(sol, pop->getVelocity(i), pBest, gBest, rands, size, k, c1, c2, low, high);
+
+                // evaluate it and publish any improvement right away
+                double fit = runSolution(sol, size, pop->getFunction());
+                pop->setFitness(i, fit);
+
+                if (fit < pop->getPBestFit(i))
+                {
+                    pop->setPBestFit(i, fit);
+                    for (int j = 0; j < size; ++j)
+                        pBest[j] = sol[j];
+
+                    pop->offerGlobalBest(sol, fit, step, i);
+                }
+            }
         }
-    }
+
+        calls += (to - from) * sweeps;
+
+        delete [] rands;
+        delete [] gBest;
+    });
+
+    pop->addFuncCalls(calls);
 }
 
 /**
- * @brief Updates the global best particle and fitness.
- *          If the population contains a particle that is
- *          more optimal that the global best, updat the
- *          global best particle and its fitness
+ * @brief Takes a migrant from another island into the swarm. It replaces
+ *          the worst particle if it is better, keeping that particle's
+ *          velocity, and updates the personal and global bests.
  * 
- * @param pop The population to update
+ * @param pop       The population of the island
+ * @param migrant   The solution of the migrant
+ * @param fitness   The fitness of the migrant
  */
-void updateGlobalBest(Population* pop)
+void acceptParticle(Population* pop, double* migrant, double fitness)
 {
-    for (int i = 0; i < pop->getPopSize(); ++i)
-    {
-        double curFit = pop->getFitness(i);
-        double glBest = pop->getGlobalBestFit();
+    int worst = pop->replaceWorst(migrant, fitness);
 
-        // check if globBest needs to be updated
-        if (curFit < glBest)
-        {
-            // update globBestFit
-            pop->setGlobalBestFit(curFit);
+    if (worst < 0)
+        return;
 
-            // update globBestVec
-            for (int j = 0; j < pop->getSolutionSize(); ++j)
-            {
-                pop->setGlobalBestVec(j, pop->getPopulation(i, j));
-            }
-        }
+    if (fitness < pop->getPBestFit(worst))
+    {
+        pop->setPBestFit(worst, fitness);
+        for (int j = 0; j < pop->getSolutionSize(); ++j)
+            pop->setPBestVec(worst, j, migrant[j]);
+
+        if (pop->getNeighbourhood() != nullptr)
+            pop->getNeighbourhood()->improve(worst, pop->getPBestFit());
     }
-}
 
+    pop->offerGlobalBest(migrant, fitness, -1, worst);
+}
 
 /**
  * @brief Initializes a population.
  *          The particles and velocities in the population
  *          are set to random values. The personal best arrays
  *          and values are set and the global best array and
- *          value is set.
+ *          value is set. With a local topology the particles
+ *          are linked into their neighbourhoods.
  *          
  * 
  * @param pop The population to initialize
+ * @param rng The random number generator of the run
  */
-void initializePSO(Population* pop)
+void initializePSO(Population* pop, Random* rng)
 {
-    // set up random number generation using mersenne twister 19937
-    random_device rd;
-    mt19937 mt(rd());
+    // the largest starting velocity
+    double maxVel = 0.5*(pop->getUpperBound() - pop->getLowerBound());
 
-    // set up random distributions
-    uniform_real_distribution<double> distrVal(pop->getLowerBound(), pop->getUpperBound());
-    uniform_real_distribution<double> distrVlct(0, 0.5*(pop->getUpperBound() - pop->getLowerBound()));
+    // spread the particles over the search space
+    initializePopulation(pop, rng);
 
-    // initialize each value to a random value
+    // give each particle a velocity from its own stream
     for (int i = 0; i < pop->getPopSize(); ++i)
-        for (int j = 0; j < pop->getSolutionSize(); ++j)
-            pop->setPopulation(i, j, distrVal(mt));
+    {
+        rng->setStream(1, i);
 
-    // generate the velocity matrix
-    for (int i = 0; i < pop->getPopSize(); ++i)
         for (int j = 0; j < pop->getSolutionSize(); ++j)
-            pop->setVelocity(i, j, distrVlct(mt));
+            pop->setVelocity(i, j, rng->uniform(0, maxVel));
+    }
     
     // generate the fitness array
     pop->generateAllFitness();
@@ -281,6 +493,7 @@ void initializePSO(Population* pop)
     // copy the current population into the personal best matrix
     for (int i = 0; i < pop->getPopSize(); ++i)
         for (int j = 0; j < pop->getSolutionSize(); ++j)
+            pop->setPBestVec(i, j, pop->getPopulation(i, j));
 
     // copy the fitness array into personal best array
     for (int i = 0; i < pop->getPopSize(); ++i)
@@ -292,12 +505,16 @@ void initializePSO(Population* pop)
     int    bestInd = pop->getIndexOfBest();
     double curBest = pop->getFitness(bestInd);
 
-    // set the global best fitness
-    pop->setGlobalBestFit(curBest);
+    // set the global best solution and fitness
+    pop->offerGlobalBest(pop->getPopulation(bestInd), curBest, 0, bestInd);
 
-    // set the global best solution
-    for (int i = 0; i < pop->getSolutionSize(); ++i)
-        pop->setGlobalBestVec(i, pop->getPopulation(bestInd, i));
+    // link the particles into neighbourhoods, if they do not all follow the global best
+    if (pop->getSwarmTopology() != SWARM_GLOBAL)
+    {
+        pop->setNeighbourhood(new Neighbourhood(pop->getSwarmTopology(), pop->getPopSize(),
+                                                pop->getInformants(), rng));
+        pop->getNeighbourhood()->reset(pop->getPBestFit());
+    }
 
 }
 
@@ -306,10 +523,11 @@ void initializePSO(Population* pop)
  * 
  * @param pop   The population object to get info from
  * @param rk    The RecordKeeper object to write info to
+ * @param stats The statistics of the final fitness array of the iteration
  * @param timer Records the legnth of each iteration
  * @param iter  Which iteration is being recorded
  */
-void updateRecords(Population* pop, RecordKeeper* rk, const clock_t timer, const int iter)
+void updateRecords(Population* pop, RecordKeeper* rk, const PopulationStats& stats, const clock_t timer, const int iter)
 {
     // save the time taken
     rk->setTimeTaken(double(timer*1000)/CLOCKS_PER_SEC, iter);
@@ -318,29 +536,16 @@ void updateRecords(Population* pop, RecordKeeper* rk, const clock_t timer, const
     rk->setFinalFuncCalls(pop->getFuncCalls(), iter);
 
     // add current fit and pBest to records
-    for (int x = 0; x < pop->getPopSize(); ++x)
-    {
-        rk->setHistoricFit(pop->getFitness(x), x, iter);
-        rk->setHistoricPBest(pop->getPBestFit(x), x, iter);
-    }
+    rk->setHistoricFit(pop->getFitness(), iter);
+    rk->setHistoricPBest(pop->getPBestFit(), iter);
     
     // add current gBest to records
     rk->setHistoricGBest(pop->getGlobalBestFit(), iter);
 
-    // find the index of the worst partile
-    int index = 0;
-    double tempFit = DBL_MIN;
-    for (int i = 0; i < pop->getPopSize(); ++i)
-    {
-        double curFit = pop->getFitness(i);
-        if (tempFit < curFit)
-        {
-            tempFit = curFit;
-            index = i;
-        }
-    }
-
-    // record the worst fitness
-    rk->setHistoricWorstFit(pop->getFitness(index), iter);
+    // record the best, worst, mean, and variance of the fitness
+    rk->setHistoricBestFit(pop->getFitness(stats.bestIndex), iter);
+    rk->setHistoricWorstFit(pop->getFitness(stats.worstIndex), iter);
+    rk->setHistoricMeanFit(stats.mean, iter);
+    rk->setHistoricVarFit(stats.variance, iter);
 }
 
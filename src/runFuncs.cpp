@@ -12,6 +12,7 @@
  * 
  */
 
+#include <chrono>
 #include <iostream>
 
 #include "functions.h"
@@ -56,3 +57,34 @@ double runSolution(double* solVec, const int size, const int func)
             exit(EXIT_FAILURE);
     }
 }
+
+/**
+ * @brief Estimates how long one call of a function takes by timing
+ *          a short burst of calls. The estimates are only compared to
+ *          each other, to start the most expensive work first.
+ * 
+ * @param func      Which function to time
+ * @param size      The size of the vectors the function will be given
+ * @return double   The average time of a call (in seconds)
+ */
+double functionCost(const int func, const int size)
+{
+    const int calls = 64;
+
+    // a fixed, nonzero vector so every function takes its usual path
+    double* solVec = new double[size];
+    for (int i = 0; i < size; ++i)
+        solVec[i] = 0.5 + 0.01 * i;
+
+    // keep the results so the calls are not optimized away
+    volatile double sink = 0.0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i)
+        sink = sink + runSolution(solVec, size, func);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    delete [] solVec;
+
+    return elapsed.count() / calls;
+}
@@ -0,0 +1,411 @@
+/**
+ * @file sampling.cpp
+ * @author Matthew Harker
+ * @brief Spreads the starting population over the search space
+ * @version 1.0
+ * @date 2019-05-20
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+#include <iostream>
+
+#include "sampling.h"
+
+using namespace std;
+
+// initial direction numbers for the Sobol dimensions after the first,
+// from Joe and Kuo's table (one row per primitive polynomial, in order)
+static const int SOBOL_TABLE_DIMS = 20;
+static const uint32_t sobolM[SOBOL_TABLE_DIMS][7] = {
+    {1},
+    {1, 3},
+    {1, 3, 1},
+    {1, 1, 1},
+    {1, 1, 3, 3},
+    {1, 3, 5, 13},
+    {1, 1, 5, 5, 17},
+    {1, 1, 5, 5, 5},
+    {1, 1, 7, 11, 19},
+    {1, 1, 5, 1, 1},
+    {1, 1, 1, 3, 11},
+    {1, 3, 5, 5, 31},
+    {1, 3, 3, 9, 7, 49},
+    {1, 1, 1, 15, 21, 21},
+    {1, 3, 1, 13, 27, 49},
+    {1, 1, 1, 15, 7, 5},
+    {1, 3, 1, 15, 13, 25},
+    {1, 1, 5, 5, 19, 61},
+    {1, 3, 7, 11, 23, 15, 103},
+    {1, 3, 7, 13, 13, 15, 69}
+};
+
+/**
+ * @brief Fills a population using the method chosen in the parameters.
+ *          Every method writes straight into the population's rows.
+ *          The randomness of each method comes from step 0 of the
+ *          generator: member i for the uniform sample, and members
+ *          past the population for the per dimension permutations
+ *          and shifts of the other methods.
+ *
+ * @param pop The population to fill
+ * @param rng The random number generator of the run
+ */
+void initializePopulation(Population* pop, Random* rng)
+{
+    switch (pop->getInitMethod())
+    {
+        case INIT_UNIFORM: uniformSample(pop, rng);  break;
+        case INIT_LATIN:   latinHypercube(pop, rng); break;
+        case INIT_HALTON:  haltonSequence(pop, rng); break;
+        case INIT_SOBOL:   sobolSequence(pop, rng);  break;
+        default:
+            cout << "Trying to use an initialization method which does not exist\n";
+            exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Fills every solution with independent uniform values
+ *
+ * @param pop The population to fill
+ * @param rng The random number generator of the run
+ */
+void uniformSample(Population* pop, Random* rng)
+{
+    double low   = pop->getLowerBound();
+    double range = pop->getUpperBound() - pop->getLowerBound();
+
+    for (int i = 0; i < pop->getPopSize(); ++i)
+    {
+        double* sol = pop->getPopulation(i);
+
+        // each solution has its own stream
+        rng->setStream(0, i);
+        rng->fillUniform(sol, pop->getSolutionSize());
+
+        for (int j = 0; j < pop->getSolutionSize(); ++j)
+            sol[j] = low + range * sol[j];
+    }
+}
+
+/**
+ * @brief Fills the population with a Latin hypercube sample.
+ *          Each dimension is cut into popSize strata and every
+ *          stratum holds exactly one solution, at a random point
+ *          inside it.
+ *
+ * @param pop The population to fill
+ * @param rng The random number generator of the run
+ */
+void latinHypercube(Population* pop, Random* rng)
+{
+    int    size   = pop->getPopSize();
+    double low    = pop->getLowerBound();
+    double stride = (pop->getUpperBound() - pop->getLowerBound()) / size;
+
+    int*    strata = new int[size];
+    double* jitter = new double[size];
+
+    for (int j = 0; j < pop->getSolutionSize(); ++j)
+    {
+        // each dimension has its own stream
+        rng->setStream(0, size + j);
+
+        // shuffle the strata (Fisher-Yates)
+        for (int i = 0; i < size; ++i)
+            strata[i] = i;
+
+        for (int i = size - 1; i > 0; --i)
+        {
+            int k = int(rng->uniform() * (i + 1));
+            int temp  = strata[i];
+            strata[i] = strata[k];
+            strata[k] = temp;
+        }
+
+        // place each solution somewhere in its stratum
+        rng->fillUniform(jitter, size);
+
+        for (int i = 0; i < size; ++i)
+            pop->setPopulation(i, j, low + stride * (strata[i] + 1.0 - jitter[i]));
+    }
+
+    delete [] strata;
+    delete [] jitter;
+}
+
+/**
+ * @brief Fills the population with a randomly shifted Halton sequence.
+ *          Dimension j is the radical inverse in the jth prime base.
+ *          Each dimension is rotated by a random amount (mod 1) so
+ *          runs with different seeds start from different points.
+ *
+ * @param pop The population to fill
+ * @param rng The random number generator of the run
+ */
+void haltonSequence(Population* pop, Random* rng)
+{
+    int    size  = pop->getPopSize();
+    double low   = pop->getLowerBound();
+    double range = pop->getUpperBound() - pop->getLowerBound();
+
+    for (int j = 0; j < pop->getSolutionSize(); ++j)
+    {
+        int    base  = nthPrime(j);
+        double shift;
+
+        // each dimension has its own stream
+        rng->setStream(0, size + j);
+        shift = rng->uniform();
+
+        // start at index 1 to skip the origin
+        for (int i = 0; i < size; ++i)
+        {
+            double inverse  = 0.0;
+            double fraction = 1.0 / base;
+
+            for (int n = i + 1; n > 0; n /= base)
+            {
+                inverse  += fraction * (n % base);
+                fraction /= base;
+            }
+
+            inverse += shift;
+            if (inverse >= 1.0)
+                inverse -= 1.0;
+
+            pop->setPopulation(i, j, low + range * inverse);
+        }
+    }
+}
+
+/**
+ * @brief Fills the population with a digitally shifted Sobol sequence.
+ *          Points are built in Gray code order, so each one is the
+ *          previous point with a single direction number XORed in.
+ *          A random 32 bit shift per dimension separates runs.
+ *
+ * @param pop The population to fill
+ * @param rng The random number generator of the run
+ */
+void sobolSequence(Population* pop, Random* rng)
+{
+    int    size  = pop->getPopSize();
+    double low   = pop->getLowerBound();
+    double range = pop->getUpperBound() - pop->getLowerBound();
+
+    uint32_t directions[32];
+
+    for (int j = 0; j < pop->getSolutionSize(); ++j)
+    {
+        uint32_t point = 0;
+        uint32_t shift;
+
+        sobolDirections(j, directions);
+
+        // each dimension has its own stream
+        rng->setStream(0, size + j);
+        shift = uint32_t((*rng)() >> 32);
+
+        // start at index 1 to skip the origin
+        for (int i = 0; i < size; ++i)
+        {
+            // the lowest zero bit of i picks the direction number
+            int bit = 0;
+            for (uint32_t n = uint32_t(i); n & 1; n >>= 1)
+                ++bit;
+
+            point ^= directions[bit];
+
+            pop->setPopulation(i, j, low + range * ((point ^ shift) * (1.0 / 4294967296.0)));
+        }
+    }
+}
+
+/**
+ * @brief Returns the nth prime, counting 2 as the 0th
+ *
+ * @param n     Which prime to return
+ * @return int  The prime
+ */
+int nthPrime(const int n)
+{
+    int found     = -1;
+    int candidate = 1;
+
+    while (found < n)
+    {
+        ++candidate;
+
+        bool prime = true;
+        for (int d = 2; d * d <= candidate; ++d)
+        {
+            if (candidate % d == 0)
+            {
+                prime = false;
+                break;
+            }
+        }
+
+        if (prime)
+            ++found;
+    }
+
+    return candidate;
+}
+
+/**
+ * @brief Multiplies two polynomials over GF(2) modulo a third
+ *
+ * @param a         The first polynomial
+ * @param b         The second polynomial
+ * @param poly      The modulus, including its leading term
+ * @param degree    The degree of the modulus
+ * @return uint32_t The product
+ */
+static uint32_t mulMod(uint32_t a, uint32_t b, const uint32_t poly, const int degree)
+{
+    uint32_t result = 0;
+
+    while (b != 0)
+    {
+        if (b & 1)
+            result ^= a;
+
+        b >>= 1;
+        a <<= 1;
+
+        if (a & (1u << degree))
+            a ^= poly;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Raises x to a power modulo a polynomial over GF(2)
+ *
+ * @param power     The exponent
+ * @param poly      The modulus, including its leading term
+ * @param degree    The degree of the modulus
+ * @return uint32_t x^power mod poly
+ */
+static uint32_t powX(uint64_t power, const uint32_t poly, const int degree)
+{
+    uint32_t result = 1;
+    uint32_t base   = (degree == 1) ? (2u ^ poly) : 2u;
+
+    while (power != 0)
+    {
+        if (power & 1)
+            result = mulMod(result, base, poly, degree);
+
+        base    = mulMod(base, base, poly, degree);
+        power >>= 1;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Checks if a polynomial over GF(2) is primitive, that is
+ *          if x has order 2^degree - 1 modulo the polynomial
+ *
+ * @param degree    The degree of the polynomial
+ * @param poly      The polynomial, including its leading term
+ * @return true     The polynomial is primitive
+ * @return false    The polynomial is not primitive
+ */
+bool isPrimitive(const int degree, const uint32_t poly)
+{
+    // a primitive polynomial always has a constant term
+    if ((poly & 1) == 0)
+        return false;
+
+    uint64_t order = (uint64_t(1) << degree) - 1;
+
+    if (powX(order, poly, degree) != 1)
+        return false;
+
+    // x must not reach 1 sooner, at any order / prime factor
+    uint64_t rest = order;
+    for (uint64_t q = 2; q * q <= rest; ++q)
+    {
+        if (rest % q == 0)
+        {
+            if (powX(order / q, poly, degree) == 1)
+                return false;
+
+            while (rest % q == 0)
+                rest /= q;
+        }
+    }
+
+    if (rest > 1 && rest != order && powX(order / rest, poly, degree) == 1)
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Builds the 32 direction numbers of a Sobol dimension.
+ *          Dimension 0 is the van der Corput sequence. Dimension d
+ *          uses the dth primitive polynomial (ordered by degree, then
+ *          by coefficients), the same order as Joe and Kuo's table.
+ *          Dimensions past the table use fixed odd initial values.
+ *
+ * @param dim           The dimension
+ * @param directions    The array of 32 direction numbers to fill
+ */
+void sobolDirections(const int dim, uint32_t* directions)
+{
+    if (dim == 0)
+    {
+        for (int k = 0; k < 32; ++k)
+            directions[k] = 1u << (31 - k);
+
+        return;
+    }
+
+    // find the polynomial of this dimension
+    int      degree = 0;
+    uint32_t coeffs = 0;
+    int      count  = 0;
+
+    while (count < dim)
+    {
+        ++degree;
+
+        for (uint32_t a = 0; a < (1u << (degree - 1)) && count < dim; ++a)
+        {
+            uint32_t poly = (1u << degree) | (a << 1) | 1u;
+
+            if (isPrimitive(degree, poly) && ++count == dim)
+                coeffs = a;
+        }
+    }
+
+    // the initial direction numbers, each odd and below 2^(k+1)
+    for (int k = 0; k < degree && k < 32; ++k)
+    {
+        uint32_t m;
+
+        if (dim <= SOBOL_TABLE_DIMS)
+            m = sobolM[dim - 1][k];
+        else
+            m = (2u * ((uint32_t(dim) * 2654435761u) >> (k + 3)) + 1u) & ((2u << k) - 1u);
+
+        directions[k] = m << (31 - k);
+    }
+
+    // the remaining ones follow from the polynomial's recurrence
+    for (int k = degree; k < 32; ++k)
+    {
+        directions[k] = directions[k - degree] ^ (directions[k - degree] >> degree);
+
+        for (int i = 1; i < degree; ++i)
+            if ((coeffs >> (degree - 1 - i)) & 1)
+                directions[k] ^= directions[k - i];
+    }
+}